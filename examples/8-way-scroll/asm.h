@@ -5,6 +5,16 @@
 
 extern void __fastcall__ coarse_scroll( int8_t offset );
 
+// Generated by lib/gen-scroll.py in to scroll.S.  Named after the direction in
+// which the characters move.  The exposed row and column are left as they were
+extern void  scroll_up( void);
+extern void  scroll_up_left( void);
+extern void  scroll_left( void);
+extern void  scroll_down_left( void);
+extern void  scroll_down( void);
+extern void  scroll_down_right( void);
+extern void  scroll_right( void);
+extern void  scroll_up_right( void);
 
-#endif
 
+#endif
@@ -3,35 +3,22 @@
 #include <stdint.h>
 #include <c64.h>
 
-#include "asm.h"
 #include "joystick.h"
+#include "pan.h"
+#include "reu.h"
+#include "shift-cells.h"
+#include "world.h"
 
 
-#define CHAR_MATRIX  ((unsigned char*)0x0400)
-
-
-struct
-{
-  uint8_t  x;
-  uint8_t  y;
-}
-view;
-
-
-// A mapping function that provides the character than should appear at the
-// specified co-ordinates
-uint8_t character_at( row, column )
-{
-  int8_t  x = view.x + column;
-  int8_t  y = view.y + row;
-  //return ( (view.y+ row) & 15 ) << 4 | ( (view.x+ column) & 15);
-  return x << 2 ^ x * y << 3 ^ y << 1;
-}
+// The joystick pans the view a cell further each way per pan for each
+// ACCELERATION pans that it is held the same way, up to MAX_STEP cells
+#define MAX_STEP      SHIFT_CELLS_MAX_STEP
+#define ACCELERATION  8
 
 
 void init()
 {
-  uint8_t  row, column;
+  uint8_t  row;
 
   VIC.bordercolor = COLOR_BLACK;
   VIC.bgcolor0 = COLOR_BLACK;
@@ -49,67 +36,55 @@ void init()
             | ( 0 << 0) // 0..7: fine horizontal scrolling
             ;
             */
+  #ifdef REU
+  // reu_shift() shifts from and to CHAR_MATRIX unless told otherwise
+  reu_present = reu_detect();
+  #endif
+
   view.x = 0;
   view.y = 0;
   for ( row = 0;  row < 25;  row += 1 )
-  {
-    uint8_t  *line = (uint8_t*)( 0x400+ 40* row );
-    for ( column = 0;  column < 40;  column += 1 )
-      line[ column] = character_at( row, column);
-  }
+    WORLD.fill_row( row);
 }
 
 
-// @param  horizontally  -1, 0 or +1, where -1 will move the view LEFT
-// @param  vertically    -1, 0 or +1, where -1 will move the view UP
-//
-void pan( int8_t horizontally, int8_t vertically )
+int main (void)
 {
-  uint8_t  row, column;
+  uint8_t  last_joy_state = 0;
+  uint8_t  held = 0;
 
-  view.x += horizontally;
-  view.y += vertically;
-
-  coarse_scroll( 40* -vertically+ -horizontally );
+  init();
 
-  if ( horizontally )
+  while( true)
   {
-    // When the view pans LEFT, the characters on-screen are moved RIGHT so
-    // newly revealed characters are on the LEFT
-    column = -1 == horizontally ? 0 : 39;
-    for ( row = 0;  row < 25;  ++row )
+    uint8_t  joy_state = joy_read();
+    int8_t   step;
+    int8_t   y_axis;
+    int8_t   x_axis;
+
+    // Count the pans for which the joystick has been held the same way
+    if ( joy_state != last_joy_state )
     {
-      CHAR_MATRIX[ 40* row+ column ] = character_at( row, column );
+      last_joy_state = joy_state;
+      held = 0;
     }
-  }
-  if ( vertically )
-  {
-    row = -1 == vertically ? 0 : 24;
-    for ( column = 0;  column < 40;  ++column )
+    step = 1+ held / ACCELERATION;
+
+    y_axis = JOY_BTN_UP(joy_state) ? -step
+           : JOY_BTN_DOWN(joy_state) ? +step
+           : 0
+           ;
+    x_axis = JOY_BTN_LEFT(joy_state) ? -step
+           : JOY_BTN_RIGHT(joy_state) ? +step
+           : 0
+           ;
+    if ( x_axis || y_axis )
     {
-      CHAR_MATRIX[ 40* row+ column ] = character_at( row, column );
+      pan( x_axis, y_axis );
+      if ( step < MAX_STEP )
+        held += 1;
     }
   }
-}
-
-
-int main (void)
-{
-  init();
-
-  while( true)
-  {
-    uint8_t  joy_state = joy_read();
-    int8_t  y_axis = JOY_BTN_UP(joy_state) ? -1
-                   : JOY_BTN_DOWN(joy_state) ? +1
-                   : 0
-                   ;
-    int8_t  x_axis = JOY_BTN_LEFT(joy_state) ? -1
-                   : JOY_BTN_RIGHT(joy_state) ? +1
-                   : 0
-                   ;
-    if ( x_axis || y_axis ) pan( x_axis, y_axis );
-  }
 
   return 0;
 }
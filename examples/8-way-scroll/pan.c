@@ -0,0 +1,65 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "asm.h"
+#include "pan.h"
+#include "reu.h"
+#include "shift-cells.h"
+#include "world.h"
+
+
+Vector  view;
+
+#ifdef REU
+bool  reu_present = false;
+#endif
+
+#ifdef SPEEDCODE
+// Indexed by 3* ( vertically+ 1)+ horizontally+ 1.  The characters move in
+// the opposite direction to the view
+static void (* const scroll[])( void) = {
+  scroll_down_right, scroll_down, scroll_down_left,
+  scroll_right,      NULL,        scroll_left,
+  scroll_up_right,   scroll_up,   scroll_up_left,
+};
+#endif
+
+
+void pan( int8_t horizontally, int8_t vertically )
+{
+  int16_t  offset = 40* -vertically+ -horizontally;
+  int8_t   edge;
+
+  view.x += horizontally;
+  view.y += vertically;
+
+  // However far the view moves, the screen is shifted once.  The speedcode
+  // is only generated for a cell each way
+  #ifdef REU
+  if ( reu_present )
+    reu_shift( offset );
+  else
+  #endif
+  if ( (uint8_t)( horizontally+ 1) <= 2  &&  (uint8_t)( vertically+ 1) <= 2 )
+  {
+    #ifdef SPEEDCODE
+    scroll[ 3* ( vertically+ 1)+ horizontally+ 1 ]();
+    #else
+    coarse_scroll( offset );
+    #endif
+  }
+  else
+    shift_cells( offset );
+
+  // When the view pans LEFT, the characters on-screen are moved RIGHT so
+  // newly revealed characters are on the LEFT
+  for ( edge = 0;  edge < -horizontally;  edge += 1 )
+    WORLD.fill_column( edge );
+  for ( edge = 0;  edge < horizontally;  edge += 1 )
+    WORLD.fill_column( 39- edge );
+  for ( edge = 0;  edge < -vertically;  edge += 1 )
+    WORLD.fill_row( edge );
+  for ( edge = 0;  edge < vertically;  edge += 1 )
+    WORLD.fill_row( 24- edge );
+}
@@ -0,0 +1,34 @@
+
+#ifndef __PAN_H
+#define __PAN_H
+
+
+// Shift the screen with the generated scroll_* routines rather than
+// coarse_scroll()
+#define SPEEDCODE
+
+// Shift the screen by DMA when a RAM Expansion Unit is present, and otherwise
+// as above
+#define REU
+
+// The generator of the world ( see world.h)
+#define WORLD  xor_world
+
+
+#ifdef REU
+// Set by init() when reu_detect() finds a REU, after which pan() shifts with
+// reu_shift()
+extern bool  reu_present;
+#endif
+
+
+// Moves view and shifts the screen to match, then fills in the exposed edges.
+// In pan.c rather than main.c so that lib/bench times the same code
+//
+// @param  horizontally  -4..+4, where -1 will move the view a cell LEFT
+// @param  vertically    -4..+4, where -1 will move the view a cell UP
+//
+extern void  pan( int8_t horizontally, int8_t vertically );
+
+
+#endif
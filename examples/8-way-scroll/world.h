@@ -0,0 +1,34 @@
+
+#ifndef __WORLD_H
+#define __WORLD_H
+
+
+typedef struct
+{
+  uint8_t  x;
+  uint8_t  y;
+}
+Vector;
+
+
+// The cell of the world at the top-left of the screen
+extern Vector  view;
+
+
+// A generator of the world.  Each fills in a whole row or column of the screen
+// from view, all in one call
+typedef struct
+{
+  void (*fill_row)( uint8_t row );
+  void (*fill_column)( uint8_t column );
+}
+Generator;
+
+// From world.S.  xor_world is x << 2 ^ x * y << 3 ^ y << 1, as character_at()
+// was, and grid_world is ( y & 15) << 4 | x & 15
+extern const Generator  xor_world;
+extern const Generator  grid_world;
+
+
+#endif
+
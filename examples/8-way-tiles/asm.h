@@ -26,6 +26,79 @@ extern void  scroll_up_right( void);
 extern void __fastcall__  render_tiles_across( uint8_t row_on_screen );
 extern void __fastcall__  render_tiles_down( uint8_t column_on_screen );
 
+// With PRERENDER, render_tiles_across renders 42 characters and
+// render_tiles_down 27, one byte per row, in to the edge strips ( see world.h)
+// rather than the edges of the screen.  These copy the exposed row from
+// tile_read_head to write_head, and the exposed column from tile_read_head to
+// the screen, for pan_in_place
+extern void  blit_row( void);
+extern void __fastcall__  blit_column( uint8_t column_on_screen );
+
+// Unpacks a row of the world packed by lib/pack-world.py from tile_read_head
+// in to write_head
+extern void  unpack_row( void);
+
+// Without DOUBLE_BUFFERED, the raster IRQ handler.  Pans the view by dx, dy
+// ( see world.h), which are all that the main loop sets, by shifting the
+// screen in place and rendering the exposed edges, or with PRERENDER copying
+// them from the edge strips once edges_ready is set.  Without PRERENDER, dx
+// and dy are then cleared
+extern void  pan_in_place( void);
+
+// The value for VIC.addr that the raster IRQ should write in order to show the
+// back screen, or 0 once it has been shown
+extern volatile uint8_t  flip_to;
+
+// With DOUBLE_BUFFERED but not SMOOTH, the raster IRQ handler.  Writes
+// flip_to to VIC.addr, unless it is 0, and with COLOUR calls flip_colour
+extern void  flip( void);
+
+// With COLOUR, the colour_* routine that the raster IRQ should call to shift
+// colour RAM when it shows the back screen
+extern void (*flip_colour)( void);
+
+// Generated by lib/gen-scroll.py in to shift.S.  Write the image of one screen
+// shifted in the direction of the name to the other screen.  The exposed row
+// and column are left as they were
+extern void  shift_a_to_b_up( void);
+extern void  shift_a_to_b_up_left( void);
+extern void  shift_a_to_b_left( void);
+extern void  shift_a_to_b_down_left( void);
+extern void  shift_a_to_b_down( void);
+extern void  shift_a_to_b_down_right( void);
+extern void  shift_a_to_b_right( void);
+extern void  shift_a_to_b_up_right( void);
+extern void  shift_b_to_a_up( void);
+extern void  shift_b_to_a_up_left( void);
+extern void  shift_b_to_a_left( void);
+extern void  shift_b_to_a_down_left( void);
+extern void  shift_b_to_a_down( void);
+extern void  shift_b_to_a_down_right( void);
+extern void  shift_b_to_a_right( void);
+extern void  shift_b_to_a_up_right( void);
+
+// Generated by lib/gen-scroll.py --slices in to slices.S for SMOOTH=1.  The
+// same shifts as above, each split in to slices of 4 rows.  Indexed by
+// 3* ( dy+ 1)+ dx+ 1, where dx and dy are the movement of the characters, and
+// then by the number of the slice.  Slices that a direction does not need
+// are NULL
+#define  SLICES  7
+extern void (* const shift_a_to_b_slices[9][SLICES])( void);
+extern void (* const shift_b_to_a_slices[9][SLICES])( void);
+
+// Generated by lib/gen-scroll.py --edges in to colour.S for COLOUR=1.  Shift
+// colour RAM in place, filling in the exposed row and column from the colours
+// that render_tiles_* left in COLOUR_EDGES ( see asm.S).  Called by the raster
+// IRQ as it shows the back screen, which they stay ahead of down the screen
+extern void  colour_up( void);
+extern void  colour_up_left( void);
+extern void  colour_left( void);
+extern void  colour_down_left( void);
+extern void  colour_down( void);
+extern void  colour_down_right( void);
+extern void  colour_right( void);
+extern void  colour_up_right( void);
+
 
 #endif
 
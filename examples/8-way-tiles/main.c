@@ -1,201 +1,426 @@
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <c64.h>
 
 #include "joystick.h"
+#include "raster.h"
+#include "reu.h"
+#include "shift-cells.h"
+#include "video.h"
 #include "asm.h"
+#include "world.h"
+#include "smooth.h"
 
 
 #define _RASTER_DEBUG
 
+// The joystick pans the view a cell further each way per pan for each
+// ACCELERATION pans that it is held the same way, up to MAX_STEP cells ( see
+// world.h)
+#define ACCELERATION  8
+
+// Set by the Makefile
+#ifndef DOUBLE_BUFFERED
+#define DOUBLE_BUFFERED 0
+#endif
+#ifndef SMOOTH
+#define SMOOTH 0
+#endif
+#ifndef COLOUR
+#define COLOUR 0
+#endif
+#ifndef COMPRESSED
+#define COMPRESSED 0
+#endif
+#ifndef PRERENDER
+#define PRERENDER 0
+#endif
+#ifndef REU
+#define REU 0
+#endif
 
-#define CHAR_MATRIX  ((uint8_t*)0x0400)
 
-#define  TILE_PATTERN            ((uint8_t*) 0x4000) // Array 0..255 of Matrix 0..3 0..3 of char codes
-#define  TILE_PATTERN_WIDTH        4
-#define  LOG2_TILE_PATTERN_WIDTH   2  // TILE_PATTERN_WIDTH is 4 ( characters across)
-#define  LOG2_TILE_PATTERN_HEIGHT  2  // TILE_PATTERN_HEIGHT is 4 ( characters across)
-#define  LOG2_TILE_PATTERN_SIZE    4  // Tile patterns are 4 x 4 = 16 characters
-#define  TILE_WITHIN_WORLD       ((uint8_t*) 0x5000) // Matrix of 32x16 tile_pattern_ids ( approx 3x3 screens)
-#define  WORLD_WIDTH_IN_TILES      32
-#define  LOG2_WORLD_WIDTH_IN_TILES  5
-#define  WORLD_HEIGHT_IN_TILES     16
+Vector  view = { 0, 0 };
+
+// View panning instructions ( from the joystick)
+int8_t  dx = 0;
+int8_t  dy = 0;
+
+uint8_t  front = 0;
+uint8_t *screen[] = { CHAR_MATRIX, BACK_MATRIX };
+uint8_t  charset;
+
+#if REU
+// Whether the screen is shifted by DMA, which it is when there is a REU
+bool  reu_present = false;
+#endif
+
+#if COLOUR
+void (* const colour[9])( void) = {
+  colour_down_right, colour_down, colour_down_left,
+  colour_right,      NULL,        colour_left,
+  colour_up_right,   colour_up,   colour_up_left,
+};
+#endif
+
+#if DOUBLE_BUFFERED  &&  ! SMOOTH
+typedef void (*Shift)( void);
+
+// Indexed by front and then 3* ( dy+ 1)+ dx+ 1.  Like scroll_*, these are named
+// after the direction in which the characters move, which is opposite to the
+// direction in which the view pans
+Shift  shift[2][9] = {
+  {
+    shift_a_to_b_down_right, shift_a_to_b_down, shift_a_to_b_down_left,
+    shift_a_to_b_right,      NULL,              shift_a_to_b_left,
+    shift_a_to_b_up_right,   shift_a_to_b_up,   shift_a_to_b_up_left,
+  },
+  {
+    shift_b_to_a_down_right, shift_b_to_a_down, shift_b_to_a_down_left,
+    shift_b_to_a_right,      NULL,              shift_b_to_a_left,
+    shift_b_to_a_up_right,   shift_b_to_a_up,   shift_b_to_a_up_left,
+  },
+};
+#endif
+
 
 
-typedef struct
+#if COMPRESSED
+// The row of the world that each row of the cache holds
+uint8_t  cached_row[ CACHED_ROWS];
+
+void unpack_world_row( uint8_t tile_row )
 {
-  uint8_t  x;
-  uint8_t  y;
+  tile_read_head = (uint8_t*)world_rows[ tile_row];
+  write_head = WORLD_ROW( tile_row);
+  unpack_row();
+  cached_row[ tile_row & ( CACHED_ROWS- 1)] = tile_row;
 }
-Vector;
 
 
-Vector  view = { 0, 0 };
-
-// View panning instructions ( from the joystick)
-int8_t  dx = 0;
-int8_t  dy = 0;
+void cache_world_row( uint8_t tile_row )
+{
+  if ( tile_row != cached_row[ tile_row & ( CACHED_ROWS- 1)] )
+    unpack_world_row( tile_row);
+}
+#endif
 
 
 
 void init()
 {
+  charset = VIC.addr & 0x0f;
+
+  // Before the raster IRQ can run
+  #if SMOOTH
+  smooth_init();
+  #endif
+
   asm_init();
 
-  VIC.imr = 0x01; // Enable "raster compare" interrupts
-  VIC.ctrl1 &= 0x7f; // Set the 9th bit of the raster compare register to 0
-  VIC.rasterline = 250; // The beginning of the bottom border by experiment with PAL version
+  #if REU
+  reu_present = reu_detect();
+  #endif
+
+  // The beginning of the bottom border, on PAL and NTSC alike.  With
+  // DOUBLE_BUFFERED alone, all there is to do there is flip, and without it
+  // the whole of the pan is in pan_in_place, both in assembly.  pan_in_place
+  // shifts the screen in place and should be done by the top of it, which on
+  // NTSC, with its shorter border, means starting it earlier, at
+  // video_budget_line, with the last rows still being shown
+  video_probe();
+  #if SMOOTH
+  raster_add( VIDEO_SCREEN_BOTTOM, raster_interrupt_handler );
+  #elif DOUBLE_BUFFERED
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, flip );
+  #else
+  raster_add_asm( video_budget_line, pan_in_place );
+  #endif
+  // Without CIA#1 interrupts
+  raster_init( false);
 
-  // Disable CIA#1 interrupts
-  CIA1.icr = 0x7f;
 
   // Fill the tiles
   {
     int i,j;
     for ( i = 0; i < 256; i ++)
     {
-      for(j=0;j<16;j++)
+      for(j=0;j<TILE_PATTERN_SIZE;j++)
       TILE_PATTERN[ (i << LOG2_TILE_PATTERN_SIZE) + j] = i;
+      #if COLOUR
+      // Any colour but that of the background
+      for(j=0;j<TILE_PATTERN_SIZE;j++)
+      TILE_COLOUR[ (i << LOG2_TILE_PATTERN_SIZE) + j] = COLOR_BLUE == (i+j) % 16 ? COLOR_WHITE : (i+j) % 16;
+      #endif
     }
   }
-  // And the world
+  #if COMPRESSED
+  // And the rows of the world that are in view
   {
-    int x,y;
-    for (x=0;x<WORLD_WIDTH_IN_TILES;x++)
+    uint8_t y;
+    for ( y = 0;  y < CACHED_ROWS  &&  y < WORLD_HEIGHT_IN_TILES;  y += 1 )
+      unpack_world_row( y);
+  }
+  #else
+  // And the world, which may be larger than int can index
+  {
+    uint16_t x,y;
+    uint8_t *tile = TILE_WITHIN_WORLD;
     for (y=0;y<WORLD_HEIGHT_IN_TILES;y++)
-    TILE_WITHIN_WORLD[ WORLD_WIDTH_IN_TILES*y +x] = WORLD_WIDTH_IN_TILES*y +x;
+    for (x=0;x<WORLD_WIDTH_IN_TILES;x++)
+    *tile++ = WORLD_WIDTH_IN_TILES*y +x;
   }
+  #endif
 }
 
 
-// @param  dx  -1, 0 or +1, where -1 will move the view LEFT
-// @param  dy    -1, 0 or +1, where -1 will move the view UP
-//
-void pan( int8_t dx, int8_t dy )
+
+void render_edges( uint8_t *matrix, int8_t dx, int8_t dy )
 {
   uint8_t  row_on_screen;
   uint8_t  column_on_screen;
+  // The first exposed row and column and the row and column after the last.
+  // When the view pans LEFT, the characters on-screen are moved RIGHT so
+  // newly revealed characters are on the LEFT
+  uint8_t  first_row = dy < 0 ? 0 : 25- dy;
+  uint8_t  end_row = dy < 0 ? -dy : 25;
+  uint8_t  first_column = dx < 0 ? 0 : 40- dx;
+  uint8_t  end_column = dx < 0 ? -dx : 40;
+  uint8_t *row_head = matrix+ 40* first_row;
   Vector   tile_within_world;
 
-  // It should not be possible to pan off the edge of the world
-  if ( dx < 0  &&  0 == view.x ) dx = 0;
-  if ( 0 < dx  &&  WORLD_WIDTH_IN_TILES*4-40 == view.x ) dx = 0;
-  if ( dy < 0  &&  0 == view.y ) dy = 0;
-  if ( 0 < dy  &&  WORLD_HEIGHT_IN_TILES*4-25 == view.y ) dy = 0;
-
-  if ( 0 == dx  &&  0 == dy) return;
-
-  view.x += dx;
-  view.y += dy;
-
-  // The border should be red to show how long the scrolling takes
-  #ifdef _RASTER_DEBUG
-  VIC.bordercolor = COLOR_RED;
+  #if COMPRESSED
+  // The newly revealed rows may be in rows of tiles that are not yet cached,
+  // which the columns also reach in to when panning diagonally
+  for ( row_on_screen = first_row;  row_on_screen < end_row;  row_on_screen += 1 )
+    cache_world_row( ( view.y + row_on_screen) >> LOG2_TILE_PATTERN_HEIGHT );
   #endif
 
-  switch (dy)
+  // Render the newly revealed left or right -most columns
+  for ( column_on_screen = first_column;  column_on_screen < end_column;  column_on_screen += 1 )
   {
-  case -1:
-    switch(dx)
-    {
-    case -1: scroll_down_right(); break;
-    case  0: scroll_down(); break;
-    case +1: scroll_down_left(); break;
-    }
-    break;
-  case 0:
-    switch(dx)
-    {
-    case -1: scroll_right(); break;
-    case +1: scroll_left(); break;
-    }
-    break;
-  case +1:
-    switch(dx)
-    {
-    case -1: scroll_up_right(); break;
-    case  0: scroll_up(); break;
-    case +1: scroll_up_left(); break;
-    }
-    break;
-  }
-
-  // The border should be cyan to show how long the edge filling takes
-  #ifdef _RASTER_DEBUG
-  VIC.bordercolor = COLOR_CYAN;
-  #endif
-
-  // If the character matrix was scrolled horizontally..
-  if ( dx )
-  {
-    // When the view pans LEFT, the characters on-screen are moved RIGHT so
-    // newly revealed characters are on the LEFT
-
-    // Render the newly revealed left or right -most column
-    column_on_screen = -1 == dx ? 0 : 39;
-
     // Work out the address (x,y) of the tile cell within the world
     tile_within_world.y = view.y >> LOG2_TILE_PATTERN_HEIGHT;
     tile_within_world.x = ( view.x +column_on_screen) >> LOG2_TILE_PATTERN_WIDTH;
-    tile_read_head = TILE_WITHIN_WORLD+ ( tile_within_world.y << LOG2_WORLD_WIDTH_IN_TILES)+ tile_within_world.x;
-    write_head = CHAR_MATRIX + column_on_screen;
+    tile_read_head = WORLD_ROW( tile_within_world.y)+ tile_within_world.x;
+    write_head = matrix + column_on_screen;
     render_tiles_down( column_on_screen );
   }
-  // If the character matrix was scrolled vertically..
-  if ( dy )
+  // Render the newly revealed top or bottom rows
+  for ( row_on_screen = first_row;  row_on_screen < end_row;  row_on_screen += 1 )
   {
-    // Render the newly revealed top or bottom row
-    row_on_screen = -1 == dy ? 0 : 24;
-    write_head = (0 == row_on_screen) ? CHAR_MATRIX : CHAR_MATRIX + 40* 24;
+    write_head = row_head;
+    row_head += 40;
 
     // Work out the address (x,y) of the tile cell within the world
-    tile_within_world.y = ( view.y + row_on_screen) >> LOG2_TILE_PATTERN_WIDTH;
-    tile_within_world.x = view.x >> LOG2_TILE_PATTERN_HEIGHT;
-    tile_read_head = TILE_WITHIN_WORLD+ ( tile_within_world.y << LOG2_WORLD_WIDTH_IN_TILES)+ tile_within_world.x;
+    tile_within_world.y = ( view.y + row_on_screen) >> LOG2_TILE_PATTERN_HEIGHT;
+    tile_within_world.x = view.x >> LOG2_TILE_PATTERN_WIDTH;
+    tile_read_head = WORLD_ROW( tile_within_world.y)+ tile_within_world.x;
     render_tiles_across( row_on_screen );
   }
 }
 
 
-void raster_interrupt_handler( void)
+#if PRERENDER
+// Set by the main loop once the edge strips hold whatever the view would
+// expose next, and cleared by pan_in_place in asm.S once the view has moved
+volatile bool  edges_ready = false;
+
+
+// @param  x  The first character of the row within the world, which may be -1
+// @param  y  The row within the world
+//
+void prerender_row( uint8_t *strip, int16_t x, int16_t y )
+{
+  // render_tiles_across takes the position within the tile from view
+  view.x = x;
+  view.y = y;
+  tile_read_head = WORLD_ROW( y >> LOG2_TILE_PATTERN_HEIGHT)+ ( x >> LOG2_TILE_PATTERN_WIDTH);
+  write_head = strip;
+  render_tiles_across( 0 );
+}
+
+
+// @param  x  The column within the world
+// @param  y  The first character of the column within the world, which may be
+//            -1
+//
+void prerender_column( uint8_t *strip, int16_t x, int16_t y )
+{
+  view.x = x;
+  view.y = y;
+  tile_read_head = WORLD_ROW( y >> LOG2_TILE_PATTERN_HEIGHT)+ ( x >> LOG2_TILE_PATTERN_WIDTH);
+  write_head = strip;
+  render_tiles_down( 0 );
+}
+
+
+// Renders the edge strips for the view as it is, so that the raster IRQ only
+// has to copy the exposed row and column whichever way the view pans next.
+// The raster IRQ does not pan until edges_ready is set, so it is safe to move
+// view and the heads about in the meantime.  Strips that the view cannot
+// reach because it is at the edge of the world are skipped
+//
+void prerender_edges( void)
 {
-  // The border should be white when the raster interrupt handler is entered
+  Vector   was = view;
+  int16_t  x = was.x- 1;
+  int16_t  y = was.y- 1;
+
+  #if COMPRESSED
+  if ( 0 < was.y )
+    cache_world_row( y >> LOG2_TILE_PATTERN_HEIGHT );
+  if ( was.y < WORLD_HEIGHT_IN_CHARS-25 )
+    cache_world_row( ( was.y+ 25) >> LOG2_TILE_PATTERN_HEIGHT );
+  #endif
+
+  if ( 0 < was.y )
+    prerender_row( TOP_STRIP, x, y );
+  if ( was.y < WORLD_HEIGHT_IN_CHARS-25 )
+    prerender_row( BOTTOM_STRIP, x, was.y+ 25 );
+  if ( 0 < was.x )
+    prerender_column( LEFT_STRIP, x, y );
+  if ( was.x < WORLD_WIDTH_IN_CHARS-40 )
+    prerender_column( RIGHT_STRIP, was.x+ 40, y );
+
+  view = was;
+}
+#endif
+
+
+#if DOUBLE_BUFFERED  &&  ! SMOOTH
+// Builds the next image in the back screen.  Without DOUBLE_BUFFERED,
+// pan_in_place in asm.S pans from within the raster IRQ instead
+//
+// @param  dx  -MAX_STEP..+MAX_STEP, where -1 will move the view a cell LEFT
+// @param  dy  -MAX_STEP..+MAX_STEP, where -1 will move the view a cell UP
+//
+void pan( int8_t dx, int8_t dy )
+{
+  uint8_t *back = screen[ 1- front];
+
+  // It should not be possible to pan off the edge of the world, so pan no
+  // further than the edge
+  if ( dx < 0  &&  view.x < -dx ) dx = -view.x;
+  if ( 0 < dx  &&  WORLD_WIDTH_IN_CHARS-40- view.x < dx ) dx = WORLD_WIDTH_IN_CHARS-40- view.x;
+  if ( dy < 0  &&  view.y < -dy ) dy = -view.y;
+  if ( 0 < dy  &&  WORLD_HEIGHT_IN_CHARS-25- view.y < dy ) dy = WORLD_HEIGHT_IN_CHARS-25- view.y;
+
+  if ( 0 == dx  &&  0 == dy) return;
+
+  view.x += dx;
+  view.y += dy;
+
+  // The border should be red to show how long the scrolling takes
   #ifdef _RASTER_DEBUG
-  VIC.bordercolor = COLOR_WHITE;
+  VIC.bordercolor = COLOR_RED;
   #endif
 
-  if ( dx || dy ) pan( dx, dy );
+  // The whole of the back screen is rewritten so whatever it held before
+  // does not matter.  The REU leaves the exposed cells alone, or fills them
+  // with the characters that wrap around from the next or previous row,
+  // either of which is rendered over.  However far the view moves, the screen
+  // is shifted once, and the shift_* routines only take a cell each way
+  #if REU
+  if ( reu_present )
+  {
+    reu_from = screen[ front];
+    reu_to = back;
+    reu_shift( 40* -dy+ -dx );
+  }
+  else
+  #endif
+  #if 1 < MAX_STEP
+  if ( 2 < (uint8_t)( dx+ 1)  ||  2 < (uint8_t)( dy+ 1) )
+  {
+    shift_from = screen[ front];
+    shift_to = back;
+    shift_cells( 40* -dy+ -dx );
+  }
+  else
+  #endif
+  shift[ front][ 3* ( dy+ 1)+ dx+ 1 ]();
 
-  // These must be set to zero in case the raster inetrrupt handler takes so
-  // long that it is re-entered immediately upon exit, meaning that the main
-  // loop does not get to run
-  dx = 0;
-  dy = 0;
+  // The border should be cyan to show how long the edge filling takes
+  #ifdef _RASTER_DEBUG
+  VIC.bordercolor = COLOR_CYAN;
+  #endif
+
+  render_edges( back, dx, dy );
+
+  // Have the raster IRQ show the back screen.  The main loop must not pan
+  // again until it has
+  #if COLOUR
+  flip_colour = colour[ 3* ( dy+ 1)+ dx+ 1 ];
+  #endif
+  front = 1- front;
+  flip_to = ( (uint16_t)screen[ front] / 1024) << 4 | charset;
 
-  // The border should be black once the raster interrupt handler has finished
   #ifdef _RASTER_DEBUG
   VIC.bordercolor = COLOR_BLACK;
   #endif
 }
+#endif
 
 
 int main (void)
 {
+  uint8_t  last_joy_state = 0;
+  uint8_t  held = 0;
+
   init();
 
   while( true)
   {
-    uint8_t  joy_state = joy_read();
-    dy = JOY_BTN_UP(joy_state) ? -1
-       : JOY_BTN_DOWN(joy_state) ? +1
+    uint8_t  joy_state;
+    int8_t   step;
+
+    #if PRERENDER
+    if ( ! edges_ready )
+    {
+      prerender_edges();
+      edges_ready = true;
+    }
+    #endif
+
+    #if DOUBLE_BUFFERED  &&  ! SMOOTH
+    // Build the next image in the back screen only once the last one has
+    // been shown
+    if ( flip_to )
+      continue;
+    #elif ! DOUBLE_BUFFERED  &&  ! PRERENDER
+    // pan_in_place clears dx and dy once it has panned
+    if ( dx || dy )
+      continue;
+    #endif
+
+    // Count the pans for which the joystick has been held the same way
+    joy_state = joy_read();
+    if ( joy_state != last_joy_state )
+    {
+      last_joy_state = joy_state;
+      held = 0;
+    }
+    step = 1+ held / ACCELERATION;
+
+    dy = JOY_BTN_UP(joy_state) ? -step
+       : JOY_BTN_DOWN(joy_state) ? +step
        : 0
        ;
-    dx = JOY_BTN_LEFT(joy_state) ? -1
-       : JOY_BTN_RIGHT(joy_state) ? +1
+    dx = JOY_BTN_LEFT(joy_state) ? -step
+       : JOY_BTN_RIGHT(joy_state) ? +step
        : 0
        ;
+    if ( ( dx || dy )  &&  step < MAX_STEP )
+      held += 1;
+
+    #if DOUBLE_BUFFERED  &&  ! SMOOTH
+    if ( dx || dy )
+      pan( dx, dy );
+    #endif
   }
 
   return 0;
@@ -0,0 +1,239 @@
+/*
+
+Pans the view by one pixel per frame in any of the eight directions ( SMOOTH=1
+in the Makefile).
+
+The view moves in steps of one cell, called moves, that take eight frames each
+and whose direction is fixed for their duration.  The fine-scroll registers
+move by a pixel every frame and when they wrap around, the character matrix
+must be shifted by a cell in the same frame.  Rather than shift it all at once,
+which would take most of a frame every eighth frame, the shifted image is built
+in the back screen one slice of 4 rows per frame during the move before, so
+that the raster IRQ only has to flip to it.
+
+The fine-scroll registers can only move the characters right and down, so
+panning RIGHT wraps them around on the last frame of a move but panning LEFT
+wraps them around on the first.  So that the coarse shift happens on the same
+frame for every direction, the flip at the start of each move shows the right-
+and down-ward parts of the move just finished and the left- and up-ward parts
+of the move just started.  The back screen for that is built during the move
+before, and so the direction of each move is read from the joystick a whole
+move ( 8 frames) ahead.  Only a move right and/or down from rest, which needs
+no coarse shift until its end, begins straight away.
+
+Per frame of a move:
+
+   0..6  Copy slice 0..6 of the shift ( fewer rows when a row is exposed)
+   6     Render the exposed row
+   7     Render the exposed column
+
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <c64.h>
+
+#include "asm.h"
+#include "world.h"
+#include "smooth.h"
+
+
+#define _RASTER_DEBUG
+
+// Set by the Makefile
+#ifndef COLOUR
+#define COLOUR 0
+#endif
+
+// Frames per move, which is the number of pixels in a cell
+#define  FRAMES  8
+
+
+typedef struct
+{
+  int8_t  dx;
+  int8_t  dy;
+}
+Move;
+
+
+// The frame within the current move, 0..FRAMES-1
+uint8_t  frame = 0;
+
+// The current move, which ends with the next flip, and the move after that,
+// which begins with it
+Move  current = { 0, 0 };
+Move  next = { 0, 0 };
+
+// The cells by which the view will move with the next flip
+Move  shift = { 0, 0 };
+
+// The values of the fine-scroll registers, 0..7.  7 is where the view rests
+uint8_t  fine_x = 7;
+uint8_t  fine_y = 7;
+
+// Written to the VIC by the next raster IRQ so that the fine scroll and the
+// screen change together
+uint8_t  next_ctrl1;
+uint8_t  next_ctrl2;
+uint8_t  next_addr;
+#if COLOUR
+void (*next_colour)( void) = NULL;
+#endif
+
+
+void compute_registers( void)
+{
+  // 24 rows ( bit 3 clear) with the display enabled
+  next_ctrl1 = ( 1 << 4) | fine_y;
+  // 38 columns ( bit 3 clear)
+  next_ctrl2 = VIC.ctrl2 & 0xf0 | fine_x;
+  next_addr = ( (uint16_t)screen[ front] / 1024) << 4 | charset;
+}
+
+
+void smooth_init( void)
+{
+  compute_registers();
+}
+
+
+// Reads the direction of the next move from the joystick
+//
+void read_next( void)
+{
+  uint16_t  x;
+  uint16_t  y;
+
+  next.dx = dx;
+  next.dy = dy;
+
+  // It should not be possible to pan off the edge of the world.  The view is
+  // where it will be once both moves are complete
+  x = view.x + ( 0 < current.dx );
+  y = view.y + ( 0 < current.dy );
+  if ( next.dx < 0  &&  0 == x ) next.dx = 0;
+  if ( 0 < next.dx  &&  WORLD_WIDTH_IN_CHARS-40 == x ) next.dx = 0;
+  if ( next.dy < 0  &&  0 == y ) next.dy = 0;
+  if ( 0 < next.dy  &&  WORLD_HEIGHT_IN_CHARS-25 == y ) next.dy = 0;
+
+  // The right- and down-ward parts of the current move and the left- and
+  // up-ward parts of the next
+  shift.dx = ( 0 < current.dx ) - ( next.dx < 0 );
+  shift.dy = ( 0 < current.dy ) - ( next.dy < 0 );
+}
+
+
+void begin_move( void)
+{
+  current = next;
+  read_next();
+
+  // From rest, a move right and/or down does not need a coarse shift until
+  // its end and so may begin straight away
+  if ( 0 == ( current.dx | current.dy | shift.dx | shift.dy ) )
+  {
+    current = next;
+    read_next();
+  }
+}
+
+
+void raster_interrupt_handler( void)
+{
+  int8_t  mx;
+  int8_t  my;
+  void (*slice)( void);
+  Vector  was;
+
+  // Before anything else, while the raster is still in the border
+  VIC.ctrl1 = next_ctrl1;
+  VIC.ctrl2 = next_ctrl2;
+  VIC.addr = next_addr;
+
+  #if COLOUR
+  // Colour RAM cannot be flipped, so shift it to match now.  This stays ahead
+  // of the raster down the screen
+  if ( next_colour )
+  {
+    next_colour();
+    next_colour = NULL;
+  }
+  #endif
+
+  // The border should be white when the raster interrupt handler is entered
+  #ifdef _RASTER_DEBUG
+  VIC.bordercolor = COLOR_WHITE;
+  #endif
+
+  if ( 0 == frame )
+    begin_move();
+
+  // Build the back screen
+  if ( shift.dx || shift.dy )
+  {
+    #ifdef _RASTER_DEBUG
+    VIC.bordercolor = COLOR_RED;
+    #endif
+
+    // Characters move opposite to the view
+    if ( frame < SLICES )
+    {
+      slice = ( 0 == front ? shift_a_to_b_slices : shift_b_to_a_slices)[ 3* ( 1- shift.dy)+ 1- shift.dx ][ frame];
+      if ( slice )
+        slice();
+    }
+
+    #ifdef _RASTER_DEBUG
+    VIC.bordercolor = COLOR_CYAN;
+    #endif
+
+    // The edges are rendered for where the view will be after the flip
+    if ( ( 6 == frame  &&  shift.dy )  ||  ( 7 == frame  &&  shift.dx ) )
+    {
+      was = view;
+      view.x += shift.dx;
+      view.y += shift.dy;
+      if ( 6 == frame )
+        render_edges( screen[ 1- front], 0, shift.dy );
+      else
+        render_edges( screen[ 1- front], shift.dx, 0 );
+      view = was;
+    }
+  }
+
+  // Work out the movement of the view during the next frame.  Stay at the
+  // start of a move until the joystick is pushed
+  if ( frame  ||  current.dx | current.dy | next.dx | next.dy )
+    frame = ( frame+ 1) % FRAMES;
+  if ( 0 == frame )
+  {
+    mx = shift.dx;
+    my = shift.dy;
+    if ( mx || my )
+    {
+      view.x += mx;
+      view.y += my;
+      front = 1- front;
+      #if COLOUR
+      next_colour = colour[ 3* ( my+ 1)+ mx+ 1 ];
+      #endif
+    }
+  }
+  else
+  {
+    mx = current.dx;
+    my = current.dy;
+  }
+  // Moving the view right moves the characters left, which is towards 0
+  fine_x = ( fine_x - mx) & 7;
+  fine_y = ( fine_y - my) & 7;
+  compute_registers();
+
+  // The border should be black once the raster interrupt handler has finished
+  #ifdef _RASTER_DEBUG
+  VIC.bordercolor = COLOR_BLACK;
+  #endif
+}
+
@@ -0,0 +1,11 @@
+#ifndef __SMOOTH_H
+#define __SMOOTH_H
+
+
+// Selects the 38-column and 24-row modes that hide the edges being scrolled
+// in and sets the fine-scroll registers to where the view rests
+extern void  smooth_init( void);
+
+
+#endif
+
@@ -0,0 +1,147 @@
+#ifndef __WORLD_H
+#define __WORLD_H
+
+
+#define CHAR_MATRIX  ((uint8_t*)0x0400)
+// The second screen for double-buffering.  Must be 1K-aligned and within the
+// VIC bank at $0000..$3fff but not at $1000..$1fff where the VIC sees the
+// character ROM
+#define BACK_MATRIX  ((uint8_t*)0x3c00)
+
+// Set by the Makefile.  Tiles are TILE_SIZE x TILE_SIZE characters, where
+// TILE_SIZE is 2, 4 or 8, and the world is up to 256 x 256 tiles
+#ifndef TILE_SIZE
+#define TILE_SIZE  4
+#endif
+#ifndef WORLD_WIDTH_IN_TILES
+#define WORLD_WIDTH_IN_TILES   32
+#endif
+#ifndef WORLD_HEIGHT_IN_TILES
+#define WORLD_HEIGHT_IN_TILES  16
+#endif
+#ifndef COLOUR
+#define COLOUR  0
+#endif
+#ifndef COMPRESSED
+#define COMPRESSED  0
+#endif
+#ifndef PRERENDER
+#define PRERENDER  0
+#endif
+#ifndef SMOOTH
+#define SMOOTH  0
+#endif
+
+#if TILE_SIZE == 2
+#define  LOG2_TILE_SIZE  1
+#elif TILE_SIZE == 4
+#define  LOG2_TILE_SIZE  2
+#elif TILE_SIZE == 8
+#define  LOG2_TILE_SIZE  3
+#else
+#error TILE_SIZE must be 2, 4 or 8
+#endif
+
+#define  TILE_PATTERN_WIDTH        TILE_SIZE
+#define  LOG2_TILE_PATTERN_WIDTH   LOG2_TILE_SIZE
+#define  LOG2_TILE_PATTERN_HEIGHT  LOG2_TILE_SIZE
+#define  LOG2_TILE_PATTERN_SIZE    ( 2* LOG2_TILE_SIZE)  // Tile patterns are TILE_SIZE x TILE_SIZE characters
+#define  TILE_PATTERN_SIZE         ( 1 << LOG2_TILE_PATTERN_SIZE)
+
+#define  WORLD_WIDTH_IN_CHARS   ( WORLD_WIDTH_IN_TILES* TILE_PATTERN_WIDTH)
+#define  WORLD_HEIGHT_IN_CHARS  ( WORLD_HEIGHT_IN_TILES* TILE_PATTERN_WIDTH)
+
+// The most cells that the view pans each way at once, which must agree with
+// asm.S.  The edge strips of PRERENDER and the colour_* routines of COLOUR are
+// only a cell deep, and SMOOTH pans a pixel at a time
+#if SMOOTH  ||  COLOUR  ||  PRERENDER
+#define  MAX_STEP  1
+#else
+#define  MAX_STEP  4  // SHIFT_CELLS_MAX_STEP of lib/shift-cells.h
+#endif
+
+// These follow each other from $4000 and must agree with asm.S, which checks
+// that the world fits below the tables at $c500
+#define  TILE_PATTERN       ((uint8_t*) 0x4000) // Array 0..255 of Matrix of TILE_SIZE x TILE_SIZE char codes
+#define  TILE_COLOUR        ( TILE_PATTERN+ 256u* TILE_PATTERN_SIZE) // With COLOUR, the colour of each character of TILE_PATTERN
+#define  TILE_WITHIN_WORLD  ( TILE_PATTERN+ ( 1+ COLOUR)* 256u* TILE_PATTERN_SIZE) // Matrix of WORLD_WIDTH_IN_TILES x WORLD_HEIGHT_IN_TILES tile_pattern_ids, by row
+
+#if COMPRESSED
+// The world is packed by lib/pack-world.py and TILE_WITHIN_WORLD holds only
+// the rows that are in view, unpacked by cache_world_row(): row y of the world
+// in to row y & ( CACHED_ROWS- 1).  CACHED_ROWS is the least power of 2 that
+// covers the rows of tiles that may be in view, or with PRERENDER in the
+// columns of the edge strips, and must agree with asm.S
+#if PRERENDER  &&  8 == TILE_SIZE
+#define  CACHED_ROWS  8
+#else
+#define  CACHED_ROWS  ( 32 >> LOG2_TILE_SIZE)
+#endif
+#define  WORLD_ROW( y)  ( TILE_WITHIN_WORLD+ ( (y) & ( CACHED_ROWS- 1))* WORLD_WIDTH_IN_TILES)
+#else
+#define  WORLD_ROW( y)  ( TILE_WITHIN_WORLD+ (y)* WORLD_WIDTH_IN_TILES)
+#endif
+
+#if PRERENDER
+// The edge strips, which the main loop renders for whichever way the view
+// pans next ( see prerender_edges()).  The rows above and below the view and
+// the columns either side of it, each a character longer at both ends so as
+// to cover the diagonals: 42 characters from view.x- 1 and 27 from view.y- 1.
+// In the back screen, which shifting in place leaves unused, and within a page
+#define  TOP_STRIP     ( BACK_MATRIX+ 0x00)
+#define  BOTTOM_STRIP  ( BACK_MATRIX+ 0x30)
+#define  LEFT_STRIP    ( BACK_MATRIX+ 0x60)
+#define  RIGHT_STRIP   ( BACK_MATRIX+ 0x80)
+#endif
+
+
+typedef struct
+{
+  uint16_t  x;
+  uint16_t  y;
+}
+Vector;
+
+
+// The cell of the world at the top-left of the screen, in characters
+extern Vector  view;
+
+// View panning instructions ( from the joystick), each -MAX_STEP..+MAX_STEP
+extern int8_t  dx;
+extern int8_t  dy;
+
+// The screen that is being shown: 0 for CHAR_MATRIX, 1 for BACK_MATRIX
+extern uint8_t  front;
+extern uint8_t *screen[];
+// The bits of VIC.addr that select the character set
+extern uint8_t  charset;
+
+// With COLOUR, the colour_* routines indexed by 3* ( dy+ 1)+ dx+ 1, where dx
+// and dy are the panning of the view
+extern void (* const colour[9])( void);
+
+
+// Renders the columns and/or rows of tiles exposed by panning the view by dx,
+// dy cells in to the given screen, which should already hold the shifted
+// image.  view should be the view after panning
+//
+extern void  render_edges( uint8_t *matrix, int8_t dx, int8_t dy );
+
+// With SMOOTH, the raster IRQ handler, in smooth.c.  Otherwise flip() or
+// pan_in_place() in asm.S does all that there is to do
+//
+extern void  raster_interrupt_handler( void);
+
+#if COMPRESSED
+// Generated by lib/pack-world.py in to world.S.  The address of each packed
+// row of the world
+extern const uint8_t * const world_rows[];
+
+// Unpacks the given row of tiles in to the cache unless it is already there
+//
+extern void  cache_world_row( uint8_t tile_row );
+#endif
+
+
+#endif
+
@@ -1,10 +0,0 @@
-
-#ifndef __ASM_H
-#define __ASM_H
-
-
-extern void asm_init( void);
-
-
-#endif
-
@@ -4,7 +4,8 @@
 #include <string.h> // for memcpy()
 #include <c64.h>
 
-#include "asm.h"
+#include "raster.h"
+#include "video.h"
 
 
 #define _RASTER_DEBUG
@@ -14,18 +15,24 @@
 #define  CUSTOM_CHARSET  ((uint8_t*) 0x2000)
 
 
+void raster_interrupt_handler( void);
+
+
 void init( void)
 {
-  asm_init();
-
   // Refer the VIC to the custom character set
   VIC.addr = ( ( (uint16_t)CHAR_MATRIX / 1024) << 4 )
            | ( ( (uint16_t)CUSTOM_CHARSET / 2048) << 1 )
            ;
 
-  VIC.imr = 0x01; // Enable "raster compare" interrupts
-  VIC.ctrl1 &= 0x7f; // Set the 9th bit of the raster compare register to 0
-  VIC.rasterline = 248; // The beginning of the bottom border by experiment with PAL version
+  // The beginning of the bottom border, on PAL and NTSC alike.  On NTSC,
+  // video_pace() has a frame in six skipped so that the animation goes at the
+  // same speed as on PAL.  The KERNAL's IRQ handler still runs to keep the
+  // keyboard scanning and jiffy clock working
+  video_probe();
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, video_pace );
+  raster_add( VIDEO_SCREEN_BOTTOM, raster_interrupt_handler );
+  raster_init( true);
 }
 
 
@@ -33,6 +40,9 @@ void raster_interrupt_handler( void)
 {
   static uint8_t  frame = 0;
 
+  if ( video_skip )
+    return;
+
   #ifdef _RASTER_DEBUG
   // Change the border color to white so it's easy to get an idea of how many
   // cycles the interrupt handler uses
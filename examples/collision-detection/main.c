@@ -26,6 +26,7 @@ The summary is that:
 #include <conio.h>
 
 #include "joystick.h"
+#include "watch.h"
 
 
 #define  RAM              ((uint8_t*) 0x0000)
@@ -35,6 +36,19 @@ The summary is that:
 #define  CUSTOM_CHARS     ((uint8_t*) 0x3000)
 
 
+// The state of the sprite to background collision register.  Reading
+// spr_bg_coll clears it, as before, once per pass.  Only sprite #0 is enabled,
+// so spr_hi_x is 0 or 1 and its two hex digits go before those of spr0_x
+WatchField  panel[] = {
+  { "coll: $", 1, 1, WATCH_HEX8, &VIC.spr_bg_coll },
+  { "prio: $", 1, 2, WATCH_HEX8, &VIC.spr_bg_prio },
+  { "   x: $", 1, 3, WATCH_HEX8, &VIC.spr_hi_x },
+  { NULL,      10, 3, WATCH_HEX8, &VIC.spr0_x },
+  { "   y: $", 1, 4, WATCH_HEX8, &VIC.spr0_y },
+  WATCH_FIELDS_END
+};
+
+
 void init()
 {
   VIC.ctrl2 = ( 0 << 5) // 0: do not reset the VIC-II
@@ -60,7 +74,7 @@ void init()
   // paged out.
   SEI(); // Disable IRQs in case the handlers expect I/O to be paged in
   RAM[0x1] = 0x32; // Chargen instead of I/O, no BASIC but KERNAL
-  memmove( (void*)0x3000, CHARACTER_ROM+8*256, 8*256 ); // "+8*256" to copy the lower-case set that cputhex8 works with
+  memmove( (void*)0x3000, CHARACTER_ROM+8*256, 8*256 ); // "+8*256" to copy the lower-case set that the labels are in
   RAM[0x1] = 0x36; // I/O and KERNAL but no BASIC ( disabled by cc65 anyway)
   CLI(); // Re-enable IRQs
 
@@ -87,6 +101,8 @@ void init()
   CHAR_MATRIX[40* 9+22] = 0x61;
   CHAR_MATRIX[40*14+17] = 0x62;
   CHAR_MATRIX[40*14+22] = 0x63;
+
+  watch_draw( panel);
 }
 
 
@@ -126,11 +142,7 @@ int main( void)
     if ( JOY_BTN_FIRE(joy_state) )
       toggle_sprite_priority();
 
-    // Show the state of the sprite to background collision register
-    gotoxy( 1, 1 ); cputs("coll: $"); cputhex8( VIC.spr_bg_coll );
-    gotoxy( 1, 2 ); cputs("prio: $"); cputhex8( VIC.spr_bg_prio );
-    gotoxy( 1, 3 ); cputs("   x: $"); cputc( VIC.spr_hi_x >> 0 & 0x1 ? '1' : '0'); cputhex8( VIC.spr0_x );
-    gotoxy( 1, 4 ); cputs("   y: $"); cputhex8( VIC.spr0_y );
+    watch_update( panel);
 
     for ( i = 0;  i < 512;  i += 1 );
   }
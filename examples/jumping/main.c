@@ -4,8 +4,9 @@
 #include <c64.h>
 #include <string.h> // for memset
 
-#include "asm.h"
 #include "joystick.h"
+#include "raster.h"
+#include "video.h"
 
 
 #define _RASTER_DEBUG
@@ -40,7 +41,11 @@
 volatile int8_t  speed = 0;  // in sub-pixels per vertical retrace
 volatile int8_t  sub_pixel_y = 0;
 
-uint8_t  joy_state = 0;
+// Joystick #2 as sampled by joy_sample() in the raster IRQ
+#define  JOY_STATE  ( joy_sampled[ JOY_PORT_2])
+
+
+void raster_interrupt_handler( void);
 
 
 bool on_the_ground()
@@ -62,19 +67,15 @@ void init()
   // ..and visible
   VIC.spr_ena = ( ENABLE << 0 );
 
-  asm_init();
-
-  // Enable "raster compare" interrupts
-  VIC.imr = ( DISABLE << 3) // Light pen interrupt enable
-          | ( DISABLE << 2) // Sprite-to-sprite collision interrupt enable
-          | ( DISABLE << 1) // Sprite-to-background collision interrupt enable
-          | ( ENABLE << 0) // "raster line compare" interrupt enable
-          ;
-  VIC.ctrl1 &= 0x7f; // Set the 9th bit of the raster compare register to 0
-  VIC.rasterline = 250; // The beginning of the bottom border by experiment with PAL version
-
-  // Disable CIA#1 interrupts
-  CIA1.icr = 0x7f;
+  // The beginning of the bottom border, on PAL and NTSC alike.  The joystick
+  // is sampled first so that animate() moves the sprite by this frame's sample,
+  // and the frames to skip on NTSC are known before animate()
+  video_probe();
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, video_pace );
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, joy_sample );
+  raster_add( VIDEO_SCREEN_BOTTOM, raster_interrupt_handler );
+  // Without the KERNAL's keyboard scanning and jiffy clock, which are not needed
+  raster_init( false);
 }
 
 
@@ -146,10 +147,10 @@ void animate()
   if ( !on_the_ground()  &&  TERMINAL_VELOCITY < speed)
     speed += ACCELERATION;
 
-  if ( JOY_BTN_LEFT(joy_state) )
+  if ( JOY_BTN_LEFT( JOY_STATE) )
     move_left();
 
-  if ( JOY_BTN_RIGHT(joy_state) )
+  if ( JOY_BTN_RIGHT( JOY_STATE) )
     move_right();
 }
 
@@ -174,7 +175,10 @@ void raster_interrupt_handler()
   VIC.bordercolor = 1;
   #endif
 
-  animate();
+  // The physics is in steps of a PAL frame, so that the jump is as high and as
+  // long on NTSC
+  if ( ! video_skip )
+    animate();
 
   #ifdef _RASTER_DEBUG
   VIC.bordercolor = 0;
@@ -184,9 +188,9 @@ void raster_interrupt_handler()
 
 void loop( void)
 {
-  joy_state = joy_read();
-
-  if ( JOY_BTN_UP(joy_state) )
+  // For as long as up is held, as when the joystick was read here, so that
+  // holding it jumps again on landing
+  if ( JOY_BTN_UP( JOY_STATE) )
     jump();
 }
 
@@ -24,40 +24,56 @@ Findings:
 #include <c64.h>
 #include <conio.h>
 
+#include "lightpen.h"
+#include "raster.h"
+#include "video.h"
+#include "watch.h"
 
-void render()
-{
-  uint8_t  row = 1;
-  cputsxy( 1, row++, "$d013 strobe_x: $"); cputhex8( VIC.strobe_x);
-  cputsxy( 1, row++, "$d014 strobe_y: $"); cputhex8( VIC.strobe_y);
-  cputsxy( 1, row++, "$d419 SID.ad1:  $"); cputhex8( SID.ad1);
-  cputsxy( 1, row++, "$d41a SID.ad2:  $"); cputhex8( SID.ad2);
-  cputsxy( 1, row++, "$dc00 CIA1.pra: $"); cputhex8( CIA1.pra);
-  cputsxy( 1, row++, "$dc01 CIA1.prb: $"); cputhex8( CIA1.prb);
-  cputsxy( 1, row++, "$dc02 CIA1.ddra: $"); cputhex8( CIA1.ddra);
-  cputsxy( 1, row++, "$dc03 CIA1.ddrb: $"); cputhex8( CIA1.ddrb);
-}
+
+// Below the screen, so that the light pen has been latched for this frame
+#define  LIGHTPEN_LINE  VIDEO_SCREEN_BOTTOM
+
+
+LightpenEvent  latest;
+uint8_t        shots = 0;
+uint8_t        held = 0;  // 1 while the trigger is held
+
+// Aimed is bit 0 of the flags
+WatchField  panel[] = {
+  { "x:       ",  1, 1, WATCH_SIGNED16, &latest.x },
+  { "y:       ",  1, 2, WATCH_SIGNED16, &latest.y },
+  { "aimed:   ",  1, 3, WATCH_BITS,     &latest.flags, "*" },
+  { "trigger: ",  1, 4, WATCH_BITS,     &held,         "*" },
+  { "shots:   $", 1, 5, WATCH_HEX8,     &shots },
+  { "frame:   $", 1, 6, WATCH_HEX8,     &latest.frame },
+  WATCH_FIELDS_END
+};
 
 
 void init()
 {
   clrscr();
+  watch_draw( panel);
 
-  // Disable CIA#1 interrupts
-  CIA1.icr = 0x7f;
-
-  // Configure to read paddles on port #2
-  CIA1.pra = 0x7f;
-
-  // Configure CIA#1 Port A as INPUT so that buttons on device in port 2 can be
-  // read.
-  CIA1.ddra = 0x00;
+  // The light pen is sampled and its trigger read in the raster IRQ.  The
+  // KERNAL is not chained, as its keyboard scan would see the trigger as a key
+  raster_add_asm( LIGHTPEN_LINE, lightpen_sample );
+  raster_init( false);
 }
 
 
 void loop( void)
 {
-  render();
+  // Every event since the last update, so that no pull of the trigger is
+  // missed however long the main loop takes
+  while ( lightpen_next_event( &latest) )
+  {
+    if ( latest.flags & LIGHTPEN_PRESSED )
+      shots += 1;
+  }
+  held = ( latest.flags & LIGHTPEN_HELD ) ? 1 : 0;
+
+  watch_update( panel);
 }
 
 
@@ -72,4 +88,3 @@ int main ( void)
 
   return 0;
 }
-
@@ -1,121 +1,59 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <c64.h>
 
+#include "mouse.h"
+#include "raster.h"
+#include "video.h"
 
-#define  CHAR_MATRIX  ((uint8_t*)0x0400)
 
-#define  SCREEN_WIDTH   40
-#define  SCREEN_HEIGHT  25
+#define  SHAPE_FOR_SPRITE  ((uint8_t*) 0x07f8)
+// The cassette buffer, which is free as there is no tape
+#define  POINTER_SHAPE     ((uint8_t*) 0x0340)
 
+#define  POINTER_SPRITE  0
 
-struct
-{
-  int8_t  x, y;
-}
-mouse_cursor = { 0, 0 };
-
-
-static void  clamp( int8_t *value, int8_t min, int8_t max )
-{
-  if ( *value < min)
-    *value = min;
-  if ( max < *value )
-    *value = max;
-}
-
-
-#define  remove_mouse_cursor  toggle_mouse_cursor
-#define  render_mouse_cursor  toggle_mouse_cursor
-static void  toggle_mouse_cursor()
-{
-  // Toggle the character under the house cursor between reverse and normal
-  // video
-  CHAR_MATRIX[ SCREEN_WIDTH*mouse_cursor.y + mouse_cursor.x ] += 0x80;
-}
-
-
-static int8_t  movement( uint8_t xm64, uint8_t prev_xm64 )
-{
-  int8_t  m = xm64 - prev_xm64;
-  if ( m <= -32)
-    m = 64 + m;
-  else if ( 32 <= m)
-    m = 64 - m;
-  return m;
-}
+// The bottom border, where the pointer sprite is not being drawn
+#define  MOUSE_LINE  VIDEO_SCREEN_BOTTOM
 
 
-static void  poll_mouse()
-{
-  static uint8_t  prev_xm64 = 0; // X position modulo 64
-  static uint8_t  prev_ym64 = 0;
-  // How to detect if x_mod64 has wrapped around or not.  There is no
-  // bulletproof method since x_mod64 might go from 0x00 to 0x3f between two
-  // polling periods and although it is *likely* that it was decreasing, it is
-  // not certain.  It might also have wrapped twice and there is no way to
-  // tell, so we just have to *assume* that the polling ( and update in the
-  // mouse - ~2 kHz in the 1531) is fast enough that the mouse cannot move fast
-  // enough to cause these problems
-  uint8_t  xm64 = ( SID.ad1 >> 1) & 0x3f;
-  uint8_t  ym64 = ( SID.ad2 >> 1) & 0x3f;
-  // If 32 < abs( x_mod64 - prev_x_mod64) then this is either a quick movement
-  // or ( more likely) a wraparound
-  int8_t  dx = movement( xm64, prev_xm64 );
-  int8_t  dy = movement( ym64, prev_ym64 );
-  if ( dx != 0  ||  dy != 0 )
-  {
-    remove_mouse_cursor();
-
-    mouse_cursor.x += dx;
-    // NOTE: "-=" below because POTY values *decrease* as the 1531 is pulled
-    // towards the user
-    mouse_cursor.y -= dy;
-    clamp( &mouse_cursor.x, 0, SCREEN_WIDTH - 1 );
-    clamp( &mouse_cursor.y, 0, SCREEN_HEIGHT - 1 );
-
-    render_mouse_cursor();
-
-    prev_xm64 = xm64;
-    prev_ym64 = ym64;
-  }
-
-  {
-    bool  lmb_is_down = ! ( CIA1.prb & 0x10);
-    bool  rmb_is_down = ! ( CIA1.prb & 0x01);
-    VIC.bordercolor = lmb_is_down | ( rmb_is_down << 1);
-  }
-}
+// An arrow with its point at the top-left, 3 bytes per row
+static const uint8_t  arrow[] = {
+  0xc0, 0x00, 0x00,
+  0xe0, 0x00, 0x00,
+  0xf0, 0x00, 0x00,
+  0xf8, 0x00, 0x00,
+  0xfc, 0x00, 0x00,
+  0xfe, 0x00, 0x00,
+  0xff, 0x00, 0x00,
+  0xf8, 0x00, 0x00,
+  0xd8, 0x00, 0x00,
+  0x8c, 0x00, 0x00,
+  0x0c, 0x00, 0x00,
+  0x06, 0x00, 0x00,
+  0x06, 0x00, 0x00,
+};
 
 
 static void  init( void)
 {
-  // Disable CIA#1 interrupts because otherwise the keyboard scanning routine
-  // will overwrite CIA1.pra and interpret mouse button clicks as key presses
-  CIA1.icr = 0x7f;
-
-  // Configure to read paddle on port #2
-  CIA1.pra = ( 1 << 0)  // Select keyboard column #0.  0:Select, 1:Ignore
-           | ( 1 << 1)  // Select keyboard column #1
-           | ( 1 << 2)  // Select keyboard column #2
-           | ( 1 << 3)  // Select keyboard column #3
-           | ( 1 << 4)  // Select keyboard column #4
-           | ( 1 << 5)  // Select keyboard column #5
-           | ( 1 << 6)  // Select keyboard column #6 and the paddles in port 1
-           | ( 1 << 7)  // Select keyboard column #7 and the paddles in port 2
-           // Coming from ignorance but this smells like a bug in VICE: Mouse
-           // emulation ( 1351 in port 1) updates POTX and POTY even when
-           // POTA[XY] are not routed to POT[XY]
-           ;
-
-  render_mouse_cursor();
-}
-
-
-static void loop( void)
-{
-  poll_mouse();
+  memset( POINTER_SHAPE, 0, 64 );
+  memcpy( POINTER_SHAPE, arrow, sizeof(arrow) );
+  SHAPE_FOR_SPRITE[ POINTER_SPRITE] = (uint16_t)POINTER_SHAPE / 64;
+  VIC.spr0_color = COLOR_WHITE;
+
+  // A 1351 in port 1.  A count is a pixel and a flick of the mouse moves the
+  // pointer further
+  mouse_init( MOUSE_PORT_1, POINTER_SPRITE );
+  mouse_acceleration = 1;
+
+  // The mouse is sampled in the raster IRQ rather than polled.  The KERNAL's
+  // keyboard scan is not chained because it would select the keyboard columns
+  // in place of the mouse's pots and see the mouse buttons as keys
+  raster_add_asm( MOUSE_LINE, mouse_sample );
+  raster_init( false);
 }
 
 
@@ -123,9 +61,10 @@ int main ( void)
 {
   init();
 
+  // The pointer moves without anything here.  This only shows the buttons
   while( true)
   {
-    loop();
+    VIC.bordercolor = mouse_buttons;
   }
 
   return 0;
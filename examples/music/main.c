@@ -0,0 +1,56 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <c64.h>
+#include <conio.h>
+
+#include "keyboard.h"
+#include "music.h"
+#include "raster.h"
+#include "sid.h"
+#include "video.h"
+
+
+// The bottom border, on PAL and NTSC alike
+#define  MUSIC_LINE  VIDEO_SCREEN_BOTTOM
+
+
+static void  init( void)
+{
+  clrscr();
+  cputsxy( 1, 1, "space: stop / play from the top");
+
+  // The song is played, the SID written and the keys scanned in the raster
+  // IRQ, in that order, so that each tick reaches the SID in its own frame.
+  // On NTSC, video_pace() skips a tick in six to keep to the tempo
+  video_probe();
+  music_init();
+  raster_add_asm( MUSIC_LINE, video_pace );
+  raster_add_asm( MUSIC_LINE, music_tick );
+  raster_add_asm( MUSIC_LINE, sid_flush );
+  raster_add_asm( MUSIC_LINE, key_scan );
+  raster_init( false);
+}
+
+
+int main ( void)
+{
+  uint8_t  key;
+
+  init();
+
+  while( true)
+  {
+    while ( key_next_event( &key) )
+    {
+      if ( KEY_SPACE != key )
+        continue;
+      if ( music_playing )
+        music_stop();
+      else
+        music_init();
+    }
+    VIC.bordercolor = music_playing ? COLOR_BLUE : COLOR_GRAY1;
+  }
+
+  return 0;
+}
@@ -1,12 +0,0 @@
-
-#ifndef __ASM_H
-#define __ASM_H
-
-
-extern void __fastcall__ ser_init( void);
-
-extern void __fastcall__ ser_putc( char data);
-
-
-#endif
-
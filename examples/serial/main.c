@@ -1,20 +1,64 @@
 
 #include <stdbool.h>
-#include <unistd.h> // for sleep()
-#include <conio.h>  // for cputc()
+#include <stdint.h>
+#include <conio.h>
 
-#include "asm.h"
+#include "raster.h"
+#include "trace.h"
+#include "video.h"
 
 
-void main()
+// The ids of the events.  See README.md for how to name them when decoding
+#define  FRAME  1  // From the raster IRQ, with how many as the payload
+#define  WORK   2  // Around the work of the main loop, with how much
+
+// Each event must be within 65536 cycles of the one before for the decoder to
+// keep time, and a frame is 19656 cycles on PAL
+#define  EVERY_FRAMES  3
+
+
+uint8_t           countdown = EVERY_FRAMES;
+volatile uint8_t  traced = 0;  // FRAME events
+
+
+void raster_interrupt_handler( void)
+{
+  if ( 0 == --countdown )
+  {
+    countdown = EVERY_FRAMES;
+    traced += 1;
+    trace( FRAME, traced );
+  }
+}
+
+
+int main( void)
 {
-  ser_init();
+  uint8_t   seen = 0;
+  uint16_t  work = 1;
+  uint16_t  i;
+
+  clrscr();
+  cputs( "tracing to the userport at 4800 baud");
+
+  video_probe();
+  trace_init( TRACE_4800);
+  raster_add( VIDEO_SCREEN_BOTTOM, raster_interrupt_handler );
+  raster_init( false);
 
   while ( true)
   {
-    ser_putc('a');
-    cputc('.');
-    sleep(1);
+    // Starts as soon as the raster IRQ has traced a frame, so that the time
+    // from FRAME to WORK is how long the main loop takes to notice
+    while ( seen == traced );
+    seen = traced;
+
+    // Of a length that changes, for the histogram of WORK to show
+    work = ( work * 5 + 1) & 0x1ff;
+    trace( WORK, work );
+    for ( i = 0;  i < work;  i += 1 );
+    trace( TRACE_END | WORK, work );
   }
-}
 
+  return 0;
+}
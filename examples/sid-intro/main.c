@@ -1,23 +1,27 @@
-/*
-
-PLAN
-  - tremolo and other effects by feeding $d41b in to other controls regularly
-
-*/
-
 #include <stdbool.h>
 #include <stdint.h>
 #include <c64.h>
 #include <conio.h>
-#include <stdlib.h>
 
+#include "keyboard.h"
+#include "modulation.h"
+#include "raster.h"
+#include "sid.h"
+#include "video.h"
+#include "watch.h"
 
-// The 6481 registers are write-only, so a copy of their values must be kept
-// for display:
-struct __sid  _shadow_SID;
-// So that generic code can access registers as a byte array:
-uint8_t  *shadow_SID = (uint8_t*)&_shadow_SID;
-uint8_t  *real_SID = (uint8_t*)&SID.v1.freq;
+
+// The cursor keys repeat while held, as they do with the KERNAL's scan: after
+// REPEAT_DELAY frames and then every REPEAT_EVERY frames
+#define  REPEAT_DELAY  16
+#define  REPEAT_EVERY   4
+#define  NOT_REPEATING  0xff
+
+
+// The 6481 registers are write-only, so lib/sid.h keeps a copy of their
+// values, which is also used for display.  Registers are changed in the copy
+// and marked, and the raster IRQ writes them to the SID:
+#define  shadow_SID  sid_shadow
 
 typedef struct
 {
@@ -60,7 +64,9 @@ Field  band_pass =    FIELD( amp, 5, 1 );
 Field  low_pass =     FIELD( amp, 4, 1 );
 Field  volume =       FIELD( amp, 0, 0xf );
 
-char     key = 0x00;
+uint8_t  key = 0x00;
+uint8_t  repeating = NOT_REPEATING; // The key that is repeating
+uint8_t  repeat_at;  // key_frame of the next repeat
 bool     showing_keys = true;
 uint8_t  voice = 0; // 0, 1 or 2 for voice 1, 2 or 3
 Field   *fields[] = {
@@ -86,6 +92,31 @@ char *name_of_field[] = {
   "master volume   ",
 };
 uint8_t  selected_field = 0;
+uint8_t  slot = 0; // The modulation slot that the keys change
+char *name_of_source[] = {
+  "off  ",
+  "lfo 1",
+  "lfo 2",
+  "env  ",
+  "osc 3",
+  "env 3",
+};
+char *name_of_destination[] = {
+  " -> frequency",
+  " -> duty     ",
+  " -> filter   ",
+  " -> volume   ",
+};
+char *name_of_voice[] = {
+  "1",
+  "2",
+  "3",
+};
+char *name_of_shape[] = {
+  "tri",
+  "saw",
+  "sqr",
+};
 
 uint16_t  ATTACK_DURATION[] = {
   2,
@@ -125,12 +156,83 @@ uint16_t  DECAY_DURATION[] = {
 };
 
 
-void cputuint( uint16_t value)
+// What the panel shows that is worked out from the shadow of the SID and the
+// selections, by render()
+struct
 {
-  char  to_s[6];
-  utoa( value, to_s, 10);
-  cputs( to_s);
+  uint16_t  freq;
+  uint16_t  hz;
+  uint16_t  pw;
+  uint8_t   duty;     // %
+  uint8_t   ctrl;
+  uint8_t   ad;
+  uint16_t  attack;   // ms
+  uint16_t  decay;    // ms
+  uint8_t   sr;
+  uint8_t   sustain;  // %
+  uint16_t  release;  // ms
+  uint16_t  cutoff;
+  uint16_t  cutoff_hz;
+  uint8_t   strength;
+  uint8_t   volume;
+  uint8_t   voice;    // 1..3
+  char     *field;
+  char     *shape[ 2];
+  char     *mark[ MOD_SLOTS];
+  char     *source[ MOD_SLOTS];
+  char     *destination[ MOD_SLOTS];
+  char     *voice_of[ MOD_SLOTS];
 }
+shown;
+
+#define  MOD_ROW( label, s, row ) \
+  { label,  1, row, WATCH_TEXT,    &shown.mark[ s] }, \
+  { NULL,   7, row, WATCH_TEXT,    &shown.source[ s] }, \
+  { NULL,  12, row, WATCH_TEXT,    &shown.destination[ s] }, \
+  { " ",   25, row, WATCH_TEXT,    &shown.voice_of[ s] }, \
+  { " ",   27, row, WATCH_SIGNED8, &mod_depth[ s] }
+
+// The registers and what they mean.  $d41b and $d41c are read from the SID
+// itself, as they are the only registers that can be
+WatchField  panel[] = {
+  { "$V+00 $",    1,  1, WATCH_HEX16,  &shown.freq },
+  { NULL,        17,  1, WATCH_DEC16,  &shown.hz },
+  { "Hz",        22,  1, WATCH_LABEL },
+  { "$V+02 $",    1,  2, WATCH_HEX16,  &shown.pw },
+  { NULL,        17,  2, WATCH_DEC8,   &shown.duty },
+  { "%",         20,  2, WATCH_LABEL },
+  { "$V+04 %",    1,  3, WATCH_BITS,   &shown.ctrl, "npstdrSg" },
+  { "$V+05 $",    1,  4, WATCH_HEX8,   &shown.ad },
+  { "A:",        17,  4, WATCH_DEC16,  &shown.attack },
+  { " D:",       24,  4, WATCH_DEC16,  &shown.decay },
+  { "ms",        32,  4, WATCH_LABEL },
+  { "$V+06 $",    1,  5, WATCH_HEX8,   &shown.sr },
+  { "S:",        17,  5, WATCH_DEC8,   &shown.sustain },
+  { "% R:",      22,  5, WATCH_DEC16,  &shown.release },
+  { "ms",        31,  5, WATCH_LABEL },
+  { "$d416 $",    1,  6, WATCH_HEX16,  &shown.cutoff },
+  { "Filter ",   17,  6, WATCH_DEC16,  &shown.cutoff_hz },
+  { "Hz",        29,  6, WATCH_LABEL },
+  { "$d417 %",    1,  7, WATCH_BITS,   &shadow_SID[ 0x17], "rrrrx123" },
+  { "Strength:", 17,  7, WATCH_DEC8,   &shown.strength },
+  { "$d418 %",    1,  8, WATCH_BITS,   &shadow_SID[ 0x18], "Qhblvvvv" },
+  { "Volume:",   17,  8, WATCH_DEC8,   &shown.volume },
+  { "$d41b $",    1,  9, WATCH_HEX8,   &SID.noise },
+  { "Oscillator #3 output", 17, 9, WATCH_LABEL },
+  { "$d41c $",    1, 10, WATCH_HEX8,   &SID.read3 },
+  { "Envelope #3 output",  17, 10, WATCH_LABEL },
+  { "voice ",     1, 11, WATCH_DEC8,   &shown.voice },
+  { "field ",     1, 12, WATCH_TEXT,   &shown.field },
+  { "lfo 1 ",     1, 14, WATCH_TEXT,   &shown.shape[ 0] },
+  { " $",        10, 14, WATCH_HEX16,  &mod_lfo_rate[ 0] },
+  { "  lfo 2 ",  16, 14, WATCH_TEXT,   &shown.shape[ 1] },
+  { " $",        27, 14, WATCH_HEX16,  &mod_lfo_rate[ 1] },
+  MOD_ROW( "mod 1", 0, 15 ),
+  MOD_ROW( "mod 2", 1, 16 ),
+  MOD_ROW( "mod 3", 2, 17 ),
+  MOD_ROW( "mod 4", 3, 18 ),
+  WATCH_FIELDS_END
+};
 
 
 void  select_field( int8_t direction)
@@ -146,6 +248,18 @@ uint8_t  offset( Field *f)
 }
 
 
+// @return  The MOD_TO_* that modulates f, or MOD_DESTINATIONS if none does
+//
+uint8_t  destination_of( Field *f)
+{
+  if ( f == &voice_freq )  return MOD_TO_FREQ;
+  if ( f == &duty_cycle )  return MOD_TO_PW;
+  if ( f == &flt_freq )    return MOD_TO_CUTOFF;
+  if ( f == &volume )      return MOD_TO_VOLUME;
+  return MOD_DESTINATIONS;
+}
+
+
 uint16_t  current( Field *f)
 {
   uint8_t  offset = offset( f);
@@ -191,15 +305,18 @@ void set( Field *f, uint16_t value )
     default:
       shadow_SID[ offset] = shadow_SID[ offset] & ~(f->mask << f->bit_position) | ( value << f->bit_position);
   }
-  real_SID[ offset] = shadow_SID[ offset];
+  sid_mark( offset);
   if ( 0xff < f->mask)
-    real_SID[ offset+1] = shadow_SID[ offset+1];
+    sid_mark( offset+1);
 }
 
 
 void adjust( Field* f, int16_t amount )
 {
-  uint16_t  value = current( f);
+  // A field that is being modulated is the base of its slot, which the raster
+  // IRQ adds the modulation to
+  uint8_t   modulated_by = mod_slot_of( destination_of( f), offset( f) );
+  uint16_t  value = ( MOD_SLOTS == modulated_by) ? current( f) : mod_base[ modulated_by];
   uint16_t  adjusted_mask = ( f->mask != 0xff07) ? f->mask : 0x7ff;
   // Some fields such as the 16-bit wide voice frequency field are so large
   // that adjustments should be made in larger steps:
@@ -209,7 +326,58 @@ void adjust( Field* f, int16_t amount )
     case 0x0fff: amount *= 16; break;
     case 0xff07: amount *= 8; break;
   }
-  set( f, (value + amount) & adjusted_mask );
+  value = ( value + amount) & adjusted_mask;
+  if ( MOD_SLOTS == modulated_by )
+    set( f, value );
+  else
+    mod_set_base( modulated_by, value );
+}
+
+
+// Connects the selected slot to the selected field of this voice, from LFO 1
+// unless it is already connected to a source
+void  wire( void)
+{
+  uint8_t  destination = destination_of( fields[ selected_field]);
+  uint8_t  source = mod_source[ slot];
+  int8_t   depth = mod_depth[ slot];
+
+  if ( MOD_DESTINATIONS == destination )
+    return;
+  if ( MOD_OFF == source )
+  {
+    source = MOD_LFO_1;
+    depth = 16;
+  }
+  mod_connect( slot, source, destination, offset( fields[ selected_field]), depth );
+}
+
+
+void  next_source( void)
+{
+  // A byte is written at once, so the raster IRQ sees the old source or the new
+  if ( MOD_OFF != mod_source[ slot] )
+    mod_source[ slot] = mod_source[ slot] % ( MOD_SOURCES - 1) + 1;
+}
+
+
+void  change_depth( int8_t amount )
+{
+  int16_t  depth = mod_depth[ slot] + amount;
+  if ( -128 <= depth  &&  depth <= 127 )
+    mod_depth[ slot] = depth;
+}
+
+
+// Halves or doubles the rate of an LFO
+void  change_rate( uint8_t lfo, bool faster )
+{
+  uint16_t  rate = mod_lfo_rate[ lfo];
+  if ( faster  &&  rate < 0x4000 )
+    rate <<= 1;
+  else if ( ! faster  &&  1 < rate )
+    rate >>= 1;
+  mod_set_lfo_rate( lfo, rate );
 }
 
 
@@ -217,13 +385,93 @@ void toggle( Field *f )
 {
   uint8_t  offset = offset( f);
   shadow_SID[ offset] ^= ( 1 << f->bit_position);
-  real_SID[ offset] = shadow_SID[ offset];
+  sid_mark( offset);
 }
 
 
-void init()
+void show_keys()
+{
+  uint8_t  row = 0;
+  cputsxy( 1, ++row, "F1     Show keys");
+  cputsxy( 1, ++row, "1..3   Select voice 1, 2 or 3");
+  cputsxy( 1, ++row, "n      Toggle Noise waveform");
+  cputsxy( 1, ++row, "p      Toggle Pulse waveform");
+  cputsxy( 1, ++row, "s      Toggle Sawtooth waveform");
+  cputsxy( 1, ++row, "t      Toggle Triangle waveform");
+  cputsxy( 1, ++row, "u      Enable/Disable this voice");
+  cputsxy( 1, ++row, "m      Toggle Ring modulation");
+  cputsxy( 1, ++row, "y      Toggle Synchronisation");
+  cputsxy( 1, ++row, "e      Toggle filtering of ext. input");
+  cputsxy( 1, ++row, "4..6   Toggle filtering of voice 1..3");
+  cputsxy( 1, ++row, "i      Toggle Voice #3 mute");
+  cputsxy( 1, ++row, "h      Toggle High-pass filter");
+  cputsxy( 1, ++row, "e      Toggle External filter");
+  cputsxy( 1, ++row, "b      Toggle Band-pass filter");
+  cputsxy( 1, ++row, "l      Toggle Low-pass filter");
+  cputsxy( 1, ++row, "g      Gate ( Play)");
+  cputsxy( 1, ++row, "r      Release");
+  cputsxy( 1, ++row, "lf/rt  select control");
+  cputsxy( 1, ++row, "up/dn  inc/dec selected control");
+  cputsxy( 1, ++row, "F3     Select modulation slot 1..4");
+  cputsxy( 1, ++row, "w/x    Wire slot to control/Unwire");
+  cputsxy( 1, ++row, "o      Next source   +/-  Depth");
+  cputsxy( 1, ++row, "7/8    LFO 1 rate  9/0 LFO 2  c/v shape");
+}
+
+
+// Works out what the panel shows
+void work_out_shown()
+{
+  uint8_t  base = 7*voice;
+  uint8_t  s;
+
+  shown.freq = current(&voice_freq);
+  shown.hz = (uint32_t)shown.freq * (video_clock >> 4) >> (24-4);
+  shown.pw = current(&duty_cycle);
+  shown.duty = (uint32_t)shown.pw * 100 / 4095;
+  shown.ctrl = shadow_SID[ base+4];
+  shown.ad = shadow_SID[ base+5];
+  shown.attack = ATTACK_DURATION[ current(&attack)];
+  shown.decay = DECAY_DURATION[ current(&decay)];
+  shown.sr = shadow_SID[ base+6];
+  shown.sustain = current(&sustain) * 100 / 15;
+  shown.release = DECAY_DURATION[ current(&release)];
+  shown.cutoff = current(&flt_freq);
+  shown.cutoff_hz = 30 + shown.cutoff * (58/2) / (10/2);
+  shown.strength = current(&flt_strength);
+  shown.volume = current(&volume);
+  shown.voice = 1+voice;
+  shown.field = name_of_field[ selected_field];
+  shown.shape[0] = name_of_shape[ mod_lfo_shape[0]];
+  shown.shape[1] = name_of_shape[ mod_lfo_shape[1]];
+  for ( s = 0;  s < MOD_SLOTS;  s += 1 )
+  {
+    bool  connected = MOD_OFF != mod_source[s];
+    shown.mark[s] = s == slot ? "*" : " ";
+    shown.source[s] = name_of_source[ mod_source[s]];
+    shown.destination[s] = connected ? name_of_destination[ mod_destination[s]] : "             ";
+    // The registers of a voice are from $d400 to $d414
+    shown.voice_of[s] = connected  &&  mod_offset[s] < 21 ? name_of_voice[ mod_offset[s] / 7] : " ";
+  }
+}
+
+
+// Draws the keys or the labels of the panel, once until F1 is pressed again
+void show()
 {
   clrscr();
+  if ( showing_keys)
+    show_keys();
+  else
+  {
+    work_out_shown();
+    watch_draw( panel);
+  }
+}
+
+
+void init()
+{
   set(&voice_freq,0x1000);
   set(&noise,1);
   set(&attack, 12 ); // 1 sec
@@ -231,114 +479,102 @@ void init()
   set(&sustain, 12 ); // 75%
   set(&release, 10 ); // 1sec5
   set(&volume,15);
+
+  // In the bottom border, on PAL and NTSC alike.  The KERNAL's CIA IRQ is not
+  // chained as the keys are scanned by key_scan() rather than the KERNAL.
+  // What the keys change is written to the SID by sid_flush() in the frame
+  // after, along with what mod_tick() modulates in that frame
+  video_probe();
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, video_pace );
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, mod_tick );
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, sid_flush );
+  raster_add_asm( VIDEO_SCREEN_BOTTOM, key_scan );
+  raster_init( false);
+
+  show();
 }
 
 
 void render()
 {
-  uint8_t  row = 0;
-  if ( showing_keys)
+  // Only the values change, which watch_update() writes if they have
+  if ( ! showing_keys)
   {
-    cputsxy( 1, ++row, "F1     Show keys");
-    cputsxy( 1, ++row, "1..3   Select voice 1, 2 or 3");
-    cputsxy( 1, ++row, "n      Toggle Noise waveform");
-    cputsxy( 1, ++row, "p      Toggle Pulse waveform");
-    cputsxy( 1, ++row, "s      Toggle Sawtooth waveform");
-    cputsxy( 1, ++row, "t      Toggle Triangle waveform");
-    cputsxy( 1, ++row, "u      Enable/Disable this voice");
-    cputsxy( 1, ++row, "m      Toggle Ring modulation");
-    cputsxy( 1, ++row, "y      Toggle Synchronisation");
-    cputsxy( 1, ++row, "e      Toggle filtering of ext. input");
-    cputsxy( 1, ++row, "4..6   Toggle filtering of voice 1..3");
-    cputsxy( 1, ++row, "i      Toggle Voice #3 mute");
-    cputsxy( 1, ++row, "h      Toggle High-pass filter");
-    cputsxy( 1, ++row, "e      Toggle External filter");
-    cputsxy( 1, ++row, "b      Toggle Band-pass filter");
-    cputsxy( 1, ++row, "l      Toggle Low-pass filter");
-    cputsxy( 1, ++row, "g      Gate ( Play)");
-    cputsxy( 1, ++row, "r      Release");
-    cputsxy( 1, ++row, "lf/rt  select control");
-    cputsxy( 1, ++row, "up/dn  inc/dec selected control");
+    work_out_shown();
+    watch_update( panel);
   }
-  else {
-    uint32_t  system_clock = 985250; // FIXME: Support NTSC clock of 1022730
-    uint16_t  frequency = (uint32_t)current(&voice_freq) * (system_clock >> 4) >> (24-4);
-    uint8_t   dc = (uint32_t)current(&duty_cycle) * 100 / 4095;
-    uint16_t  cutoff_freq = 30 + current(&flt_freq) * (58/2) / (10/2);
-    cputsxy( 1, ++row, "$V+00 $"); cputhex16( current(&voice_freq) ); gotoxy( 17, row); cputuint( frequency); cputs("Hz    ");
-    cputsxy( 1, ++row, "$V+02 $"); cputhex16( current(&duty_cycle) ); gotoxy( 17, row); cputuint( dc); cputs("%    ");
-    cputsxy( 1, ++row, "$V+04 %"); cputc( current(&noise) ?        'n' : '-');
-                                   cputc( current(&pulse) ?        'p' : '-');
-                                   cputc( current(&sawtooth) ?     's' : '-');
-                                   cputc( current(&triangle) ?     't' : '-');
-                                   cputc( current(&voice_enable) ? 'd' : '-');
-                                   cputc( current(&ring_mod) ?     'r' : '-');
-                                   cputc( current(&sync) ?         'S' : '-');
-                                   cputc( 'X');
-    cputsxy( 1, ++row, "$V+05 $"); cputhex8( shadow_SID[7*voice+5]);
-                                   cputsxy( 17, row, "A:"); cputuint(ATTACK_DURATION[ current(&attack)]);
-                                   cputs(" D:"); cputuint( DECAY_DURATION[current(&decay)]); cputs(" ms       ");
-                                   // A:1-4 chars, D:1-5 chars. min:2, max:9, hence 7 spaces
-    cputsxy( 1, ++row, "$V+06 $"); cputhex8( shadow_SID[7*voice+6]);
-                                   cputsxy( 17, row, "S:"); cputuint( current(&sustain) * 100 / 15);
-                                   cputs("% R:"); cputuint( DECAY_DURATION[current(&release)]); cputs("ms      ");
-                                   // S:1-3 chars, R:1-5 chars. min:2, max:8, hence 6 spaces
-    cputsxy( 1, ++row, "$d416 $"); cputhex16( current(&flt_freq)); cputsxy( 17, row, "Filter "); cputuint( cutoff_freq); cputs("Hz    ");
-    cputsxy( 1, ++row, "$d417 %"); cputs("????");
-                                   cputc( current(&flt_ext) ? 'x' : '-');
-                                   cputc( current(&flt_v1) ? '1' : '-');
-                                   cputc( current(&flt_v2) ? '2' : '-');
-                                   cputc( current(&flt_v3) ? '3' : '-');
-                                   cputsxy( 17, row, "Strength:"); cputuint( current(&flt_strength)); cputc(' ');
-    cputsxy( 1, ++row, "$d418 %"); cputc( current(&disable_v3) ? 'Q' : '-');
-                                   cputc( current(&high_pass) ? 'h' : '-');
-                                   cputc( current(&band_pass) ? 'b' : '-');
-                                   cputc( current(&low_pass) ? 'L' : '-');
-                                   cputs("????");
-                                   cputs(" Volume:"); cputuint( current(&volume)); cputc(' ');
-    cputsxy( 1, ++row, "$d41b $"); cputhex8( SID.noise); cputsxy( 17, row, "Oscillator #3 output");
-    cputsxy( 1, ++row, "$d41c $"); cputhex8( SID.read3); cputsxy( 17, row, "Envelope #3 output");
-    cputsxy( 1, ++row, "voice "); cputc('1'+voice);
-    cputsxy( 1, ++row, "field "); cputs( name_of_field[ selected_field]);
-    //cputsxy( 1, ++row, "key:              $"); cputhex8( key);
+}
+
+
+void press( uint8_t key )
+{
+  switch ( key)
+  {
+    case KEY_F1:          showing_keys ^= true; show(); break;
+    case KEY_1:           voice = 0; break; // Select Voice #1
+    case KEY_2:           voice = 1; break; // Select Voice #2
+    case KEY_3:           voice = 2; break; // Select Voice #3
+    case KEY_4:           toggle(&flt_v1); break;
+    case KEY_5:           toggle(&flt_v2); break;
+    case KEY_6:           toggle(&flt_v3); break;
+    case KEY_N:           toggle(&noise); break;
+    case KEY_P:           toggle(&pulse); break;
+    case KEY_S:           toggle(&sawtooth); break;
+    case KEY_T:           toggle(&triangle); break;
+    case KEY_U:           toggle(&voice_enable); break;
+    case KEY_M:           toggle(&ring_mod); break;
+    case KEY_Y:           toggle(&sync); break;
+    case KEY_E:           toggle(&flt_ext); break;
+    case KEY_I:           toggle(&disable_v3); break;
+    case KEY_H:           toggle(&high_pass); break;
+    case KEY_B:           toggle(&band_pass); break;
+    case KEY_L:           toggle(&low_pass); break;
+    // With SHIFT, CRSR DOWN is CRSR UP and CRSR RIGHT is CRSR LEFT
+    case KEY_CRSR_DOWN:   adjust( fields[selected_field], KEY_SHIFTED() ? +1 : -1 ); break;
+    case KEY_CRSR_RIGHT:  select_field( KEY_SHIFTED() ? -1 : +1 ); break;
+    case KEY_G:           set(&gate, 1); mod_trigger(); break;
+    case KEY_R:           set(&gate, 0); break;
+    case KEY_F3:          slot = ( slot + 1) % MOD_SLOTS; break;
+    case KEY_W:           wire(); break;
+    case KEY_X:           mod_disconnect( slot); break;
+    case KEY_O:           next_source(); break;
+    case KEY_PLUS:        change_depth( +1); break;
+    case KEY_MINUS:       change_depth( -1); break;
+    case KEY_7:           change_rate( 0, false ); break;
+    case KEY_8:           change_rate( 0, true ); break;
+    case KEY_9:           change_rate( 1, false ); break;
+    case KEY_0:           change_rate( 1, true ); break;
+    case KEY_C:           mod_lfo_shape[0] = ( mod_lfo_shape[0] + 1) % MOD_SHAPES; break;
+    case KEY_V:           mod_lfo_shape[1] = ( mod_lfo_shape[1] + 1) % MOD_SHAPES; break;
   }
 }
 
 
 void loop( void)
 {
-  if ( kbhit())
+  // Every press since the last render, which may have taken several frames
+  while ( key_next_event( &key) )
   {
-    switch ( key = cgetc() )
+    if ( key & KEY_RELEASED)
+    {
+      if ( ( key & ~KEY_RELEASED) == repeating )
+        repeating = NOT_REPEATING;
+      continue;
+    }
+    press( key);
+    if ( KEY_CRSR_DOWN == key  ||  KEY_CRSR_RIGHT == key  ||  KEY_PLUS == key  ||  KEY_MINUS == key )
     {
-      case CH_F1:         showing_keys ^= true; clrscr(); break;
-      case '1':           voice = 0; break; // Select Voice #1
-      case '2':           voice = 1; break; // Select Voice #2
-      case '3':           voice = 2; break; // Select Voice #3
-      case '4':           toggle(&flt_v1); break;
-      case '5':           toggle(&flt_v2); break;
-      case '6':           toggle(&flt_v3); break;
-      case 'n':           toggle(&noise); break;
-      case 'p':           toggle(&pulse); break;
-      case 's':           toggle(&sawtooth); break;
-      case 't':           toggle(&triangle); break;
-      case 'u':           toggle(&voice_enable); break;
-      case 'm':           toggle(&ring_mod); break;
-      case 'y':           toggle(&sync); break;
-      case 'e':           toggle(&flt_ext); break;
-      case 'i':           toggle(&disable_v3); break;
-      case 'h':           toggle(&high_pass); break;
-      case 'b':           toggle(&band_pass); break;
-      case 'l':           toggle(&low_pass); break;
-      case CH_CURS_UP:    adjust( fields[selected_field], +1 ); break;
-      case CH_CURS_DOWN:  adjust( fields[selected_field], -1 ); break;
-      case CH_CURS_LEFT:  select_field(-1); break;
-      case CH_CURS_RIGHT: select_field(+1); break;
-      case 'g':           set(&gate, 1); break;
-      case 'r':           set(&gate, 0); break;
+      repeating = key;
+      repeat_at = key_frame + REPEAT_DELAY;
     }
   }
 
+  if ( NOT_REPEATING != repeating  &&  0 <= (int8_t)( key_frame - repeat_at) )
+  {
+    press( repeating);
+    repeat_at += REPEAT_EVERY;
+  }
+
   render();
 }
 
@@ -3,7 +3,9 @@
 #include <stdint.h>
 #include <string.h> // for memset
 #include <c64.h>
-#include <conio.h>  // for cput*
+#include <conio.h>  // for kbhit and cgetc
+
+#include "watch.h"
 
 
 #define  CHAR_MATRIX      ((uint8_t*) 0x0400)
@@ -26,6 +28,36 @@ int8_t  to_ceiling;
 int8_t  to_wall_on_left;
 int8_t  to_wall_on_right;
 
+// The parameters to the formula, as shown
+uint8_t  fine_x;
+uint8_t  fine_y;
+uint8_t  cell_x;
+uint8_t  cell_fine_x;
+uint8_t  cell_y;
+uint8_t  cell_fine_y;
+
+// The cells painted by the last render(), which the next paints back first.
+// Within the matrix before the first
+uint8_t  center_column = 1;
+uint8_t  row_above = 0;
+uint8_t  row_below = 1;
+
+WatchField  panel[] = {
+  { "fine: $",    1, 21, WATCH_HEX8, &fine_x },
+  { ",",          9, 21, WATCH_HEX8, &fine_y },
+  { "sprt: $",    1, 22, WATCH_HEX8, &VIC.spr0_x },
+  { ",",          9, 22, WATCH_HEX8, &VIC.spr0_y },
+  { "cell: $",    1, 23, WATCH_HEX8, &cell_x },
+  { ".",          9, 23, WATCH_HEX8, &cell_fine_x },
+  { ",",         12, 23, WATCH_HEX8, &cell_y },
+  { ".",         15, 23, WATCH_HEX8, &cell_fine_y },
+  { "to_surf: $", 20, 21, WATCH_HEX8, &to_surface },
+  { "to_wall: $", 20, 22, WATCH_HEX8, &to_wall_on_left },
+  { ",",         32, 22, WATCH_HEX8, &to_wall_on_right },
+  { "to_ceil: $", 20, 23, WATCH_HEX8, &to_ceiling },
+  WATCH_FIELDS_END
+};
+
 
 void place( code, column, row)
 {
@@ -74,13 +106,44 @@ void move_sprite_on_x( int8_t amount )
 }
 
 
+// Paints the cells considered for collision, or paints them back to green
+void paint_probes( bool erase )
+{
+  uint8_t  ceiling = erase ? COLOR_GREEN : COLOR_LIGHTBLUE;
+  uint8_t  ground =  erase ? COLOR_GREEN : COLOR_YELLOW;
+  uint8_t  wall =    erase ? COLOR_GREEN : COLOR_ORANGE;
+
+  // Cells painted LIGHT BLUE are considered as the ceiling for collision
+  // ( cuts a jump short)
+  paint( ceiling, center_column-1, row_above );
+  paint( ceiling, center_column,   row_above );
+  paint( ceiling, center_column+1, row_above );
+  // Cells painted YELLOW are considered as the ground for collision ( arrests
+  // a fall)
+  paint( ground, center_column-1, row_below );
+  paint( ground, center_column,   row_below );
+  paint( ground, center_column+1, row_below );
+  // Cells painted PINK are considered as walls for collision ( prevents
+  // further movement in to the wall).  Note that the sprite is allowed to
+  // overlap with the wall slightly because the sprite is allowed to fall
+  // overlapped with the wall.  It's allowed to fall overlapped with the wall
+  // because the feet of a character are not the full width of the sprite so
+  // the actor would appear to be hovering in the air just prior to falling
+  // otherwise ( cf. Creatures).
+  // The alternative would be to have the actor move through the air while
+  // falling such that the shortest drop in the game nevertheless produced
+  // enough horizontal movement to get the actor clear of the wall ( cf.
+  // Dizzy).  It would be jarring to allow a fall overlapping the wall but to
+  // prevent the actor moving back to overlap the wall again having moved away.
+  paint( wall, center_column - 1, row_below - 1 );
+  paint( wall, center_column + 1, row_below - 1 );
+}
+
+
 void render()
 {
   uint16_t  left;
   uint8_t   top;
-  uint8_t   center_column;
-  uint8_t   row_above;
-  uint8_t   row_below;
   uint16_t  below_left_ofs;
   uint16_t  above_left_ofs;
 
@@ -93,12 +156,17 @@ void render()
   left = ( ((VIC.spr_hi_x >> 0 & 0x1)<< 8) + VIC.spr0_x) - SPRITE_X_LEFT - FINE_SCRL_X;
   top = VIC.spr0_y - SPRITE_Y_TOP + NORM_FINE_Y - FINE_SCRL_Y;
 
-  // Show the parameters to the formula
-  cputsxy( 1, 21, "fine: $"); cputhex8( FINE_SCRL_X); cputc(','); cputhex8( FINE_SCRL_Y);
-  cputsxy( 1, 22, "sprt: $"); cputhex8( VIC.spr0_x); cputc(','); cputhex8( VIC.spr0_y);
-  cputsxy( 1, 23, "cell: $"); cputhex8( left >> 3); cputc('.'); cputhex8( left & 0x7); cputc(','); cputhex8( top >> 3); cputc('.'); cputhex8( top & 0x7);
+  // The parameters to the formula
+  fine_x = FINE_SCRL_X;
+  fine_y = FINE_SCRL_Y;
+  cell_x = left >> 3;
+  cell_fine_x = left & 0x7;
+  cell_y = top >> 3;
+  cell_fine_y = top & 0x7;
+
+  // Only the cells that were painted before, rather than the whole matrix
+  paint_probes( true);
 
-  memset( COLOR_RAM, COLOR_GREEN, 40*20);
   // Find the row of cells within the character matrix immediately below the
   // "feet" of the sprite
   row_above = top - 1 >> 3;
@@ -109,31 +177,7 @@ void render()
   // Show the character matrix cells that will be considered for collision
   below_left_ofs = 40*row_below + center_column - 1;
   above_left_ofs = 40*row_above + center_column - 1;
-
-  // Cells painted LIGHT BLUE are considered as the ceiling for collision
-  // ( cuts a jump short)
-  paint( COLOR_LIGHTBLUE, center_column-1, row_above );
-  paint( COLOR_LIGHTBLUE, center_column,   row_above );
-  paint( COLOR_LIGHTBLUE, center_column+1, row_above );
-  // Cells painted YELLOW are considered as the ground for collision ( arrests
-  // a fall)
-  paint( COLOR_YELLOW, center_column-1, row_below );
-  paint( COLOR_YELLOW, center_column,   row_below );
-  paint( COLOR_YELLOW, center_column+1, row_below );
-  // Cells painted PINK are considered as walls for collision ( prevents
-  // further movement in to the wall).  Note that the sprite is allowed to
-  // overlap with the wall slightly because the sprite is allowed to fall
-  // overlapped with the wall.  It's allowed to fall overlapped with the wall
-  // because the feet of a character are not the full width of the sprite so
-  // the actor would appear to be hovering in the air just prior to falling
-  // otherwise ( cf. Creatures).
-  // The alternative would be to have the actor move through the air while
-  // falling such that the shortest drop in the game nevertheless produced
-  // enough horizontal movement to get the actor clear of the wall ( cf.
-  // Dizzy).  It would be jarring to allow a fall overlapping the wall but to
-  // prevent the actor moving back to overlap the wall again having moved away.
-  paint( COLOR_ORANGE, center_column - 1, row_below - 1 );
-  paint( COLOR_ORANGE, center_column + 1, row_below - 1 );
+  paint_probes( false);
   // In theory, "row_below - 1" and " - 2" should be checked to prevent
   // sideways movement too although the cycles can be saved if the map contains
   // no crawlspaces 1 or 2 cells in height
@@ -153,9 +197,7 @@ void render()
   to_wall_on_right = MIN_SOLID_CODE <= CHAR_MATRIX[ below_left_ofs - 40 + 2 ]
     ? ( left + SPRITE_WIDTH/2 + 8 ) - ( center_column + 1 << 3) : -1;
 
-  cputsxy( 20, 21, "to_surf: $"); cputhex8( to_surface);
-  cputsxy( 20, 22, "to_wall: $"); cputhex8( to_wall_on_left); cputc(','); cputhex8( to_wall_on_right);
-  cputsxy( 20, 23, "to_ceil: $"); cputhex8( to_ceiling);
+  watch_update( panel);
 }
 
 
@@ -176,6 +218,7 @@ void init()
   // Fill the screen with chequerboard glyphs intended to denote free space but
   // which still show the color highlighting
   memset( CHAR_MATRIX, 0x66, 40*20);
+  memset( COLOR_RAM, COLOR_GREEN, 40*20);
 
   // Make a box of solid glyphs to aid with visualisation of collision with the
   // ground, walls and ceiling
@@ -190,6 +233,7 @@ void init()
     }
   }
 
+  watch_draw( panel);
   render();
 }
 
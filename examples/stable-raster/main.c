@@ -0,0 +1,55 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <c64.h>
+#include <conio.h>
+
+#include "raster.h"
+#include "video.h"
+
+
+// The first line of each band of bars, in the bottom border where there are
+// no badlines.  The stable band is drawn by raster_add_stable() and the other
+// by raster_add_asm() for comparison
+#define  STABLE_BARS    260
+#define  UNSTABLE_BARS  276
+
+
+// See bars.S
+void  bars( void);
+
+
+void init( void)
+{
+  VIC.bordercolor = COLOR_BLACK;
+
+  // raster_add_stable() and bars.S are timed for the 63 cycles per line of
+  // PAL, and the bars are on lines that NTSC does not have
+  video_probe();
+  if ( ! raster_add_stable( STABLE_BARS, bars ) )
+  {
+    cputsxy( 1, 1, "stable-raster needs a PAL C64");
+    return;
+  }
+  raster_add_asm( UNSTABLE_BARS, bars );
+
+  // The KERNAL's CIA IRQ would break in to the stable handler, so there is no
+  // keyboard scanning
+  raster_init( false);
+}
+
+
+int main( void)
+{
+  volatile uint16_t  spin = 0;
+
+  init();
+
+  // Instructions of different lengths for the raster IRQ to interrupt, so
+  // that the unstable band shows its jitter
+  while ( true)
+    spin += 1;
+
+  return 0;
+}
+
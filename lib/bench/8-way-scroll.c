@@ -0,0 +1,172 @@
+/*
+
+Harness for timing coarse_scroll(), the generated scroll_* routines, the
+generators of the world and pan() from examples/8-way-scroll, and
+reu_shift() and shift_cells() from lib/, under sim65:
+
+  bench-8-way-scroll <run|dry> <routine> [ <offset for coarse_scroll, reu_shift or shift_cells> ]
+  bench-8-way-scroll <run|dry> <generator>_<fill_row|fill_column> <edge> <view.x> <view.y>
+  bench-8-way-scroll <run|dry> pan <dx> <dy>
+
+<generator> is "xor_world", "grid_world" or "character_at", which fills the
+edge cell by cell with the character_at() that examples/8-way-scroll had
+before world.S, for comparison.  <edge> is the row or column on screen.
+"pan" is pan() from examples/8-way-scroll/pan.c itself, with no REU found.
+
+sim65 has no REU, so reu_shift() writes to RAM at $df00 and only the cycles
+that the CPU spends setting up the transfers are counted here.  A "dry" run does everything except invoke the routine so that bench.sh can
+subtract the cost of starting up, parsing arguments and exiting
+
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asm.h"
+#include "pan.h"
+#include "reu.h"
+#include "shift-cells.h"
+#include "world.h"
+
+
+#define  CHAR_MATRIX  ((uint8_t*)0x0400)
+
+
+// As examples/8-way-scroll had it before world.S
+uint8_t character_at( row, column )
+{
+  int8_t  x = view.x + column;
+  int8_t  y = view.y + row;
+  return x << 2 ^ x * y << 3 ^ y << 1;
+}
+
+void  character_at_fill_row( uint8_t row )
+{
+  uint8_t  column;
+  for ( column = 0;  column < 40;  ++column )
+  {
+    CHAR_MATRIX[ 40* row+ column ] = character_at( row, column );
+  }
+}
+
+void  character_at_fill_column( uint8_t column )
+{
+  uint8_t  row;
+  for ( row = 0;  row < 25;  ++row )
+  {
+    CHAR_MATRIX[ 40* row+ column ] = character_at( row, column );
+  }
+}
+
+const Generator  character_at_world = { character_at_fill_row, character_at_fill_column };
+
+
+typedef void (*Routine)( void);
+
+char *name_of_generator[] = {
+  "xor_world",
+  "grid_world",
+  "character_at",
+};
+const Generator *generator[] = {
+  &xor_world,
+  &grid_world,
+  &character_at_world,
+};
+
+char *name_of_scroll[] = {
+  "scroll_up",
+  "scroll_up_left",
+  "scroll_left",
+  "scroll_down_left",
+  "scroll_down",
+  "scroll_down_right",
+  "scroll_right",
+  "scroll_up_right",
+};
+Routine  scroll[] = {
+  scroll_up,
+  scroll_up_left,
+  scroll_left,
+  scroll_down_left,
+  scroll_down,
+  scroll_down_right,
+  scroll_right,
+  scroll_up_right,
+};
+
+
+int main( int argc, char *argv[] )
+{
+  bool     dry = 0 == strcmp( argv[1], "dry");
+  char    *routine = argv[2];
+  int      i;
+
+  (void)argc;
+
+  // Something other than zeros to shift around
+  for ( i = 0;  i < 40*25;  i += 1 )
+    CHAR_MATRIX[ i] = i;
+
+  if ( 0 == strcmp( routine, "coarse_scroll") )
+  {
+    int8_t  offset = atoi( argv[3]);
+    if ( ! dry )
+      coarse_scroll( offset);
+  }
+  else if ( 0 == strcmp( routine, "reu_shift") )
+  {
+    int16_t  offset = atoi( argv[3]);
+    if ( ! dry )
+      reu_shift( offset);
+  }
+  else if ( 0 == strcmp( routine, "shift_cells") )
+  {
+    int16_t  offset = atoi( argv[3]);
+    if ( ! dry )
+      shift_cells( offset);
+  }
+  else if ( 0 == strcmp( routine, "pan") )
+  {
+    int8_t  dx = atoi( argv[3]);
+    int8_t  dy = atoi( argv[4]);
+    if ( ! dry )
+      pan( dx, dy);
+  }
+  else if ( strstr( routine, "_fill_") )
+  {
+    uint8_t  edge = atoi( argv[3]);
+    view.x = atoi( argv[4]);
+    view.y = atoi( argv[5]);
+    for ( i = 0;  i < sizeof(generator) / sizeof(generator[0]);  i += 1 )
+    {
+      if ( 0 == strncmp( routine, name_of_generator[ i], strlen( name_of_generator[ i])) )
+        break;
+    }
+    if ( i == sizeof(generator) / sizeof(generator[0]) )
+      return 1;
+    if ( ! dry )
+    {
+      if ( strstr( routine, "_fill_row") )
+        generator[ i]->fill_row( edge);
+      else
+        generator[ i]->fill_column( edge);
+    }
+  }
+  else
+  {
+    for ( i = 0;  i < sizeof(scroll) / sizeof(scroll[0]);  i += 1 )
+    {
+      if ( 0 == strcmp( routine, name_of_scroll[ i]) )
+        break;
+    }
+    if ( i == sizeof(scroll) / sizeof(scroll[0]) )
+      return 1;
+    if ( ! dry )
+      scroll[ i]();
+  }
+
+  return 0;
+}
@@ -0,0 +1,291 @@
+/*
+
+Harness for timing the scroll_*, shift_a_to_b_*, shift_a_to_b_slices,
+colour_*, render_tiles_*, unpack_row and pan_in_place routines from
+examples/8-way-tiles under sim65:
+
+  bench-8-way-tiles <run|dry> <routine> <edge> <view.x> <view.y> [ <step> ]
+
+<edge> is the row ( render_tiles_across) or column ( render_tiles_down) on
+screen that is rendered and is ignored by the scroll_* routines.  For
+"slice", <edge> is the index of the direction in shift_a_to_b_slices and
+<view.x> is the number of the slice.  For "unpack_row", <edge> is the row of
+the world packed by lib/pack-world.py to unpack.  For "pan_in_place", <edge>
+is the direction 3* ( dy+ 1)+ dx+ 1 and <step> the cells to pan that way ( 1
+unless given), as it is for "pan_c", a copy of the C that pan_in_place
+replaced, for comparison, which only pans a cell at a time.  A "dry" run
+does everything except invoke the routine so that bench.sh can subtract the
+cost of starting up, setting up and exiting
+
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asm.h"
+
+
+#define  CHAR_MATRIX  ((uint8_t*)0x0400)
+
+// These must agree with examples/8-way-tiles/world.h for the default geometry
+// and without COLOUR, which is how the Makefile assembles asm.S
+#define  TILE_PATTERN            ((uint8_t*) 0x4000)
+#define  LOG2_TILE_PATTERN_SIZE    4
+#define  LOG2_TILE_PATTERN_WIDTH   2
+#define  LOG2_TILE_PATTERN_HEIGHT  2
+#define  TILE_WITHIN_WORLD       ((uint8_t*) 0x5000)
+#define  WORLD_WIDTH_IN_TILES      32
+#define  WORLD_HEIGHT_IN_TILES     16
+
+
+typedef struct
+{
+  uint16_t  x;
+  uint16_t  y;
+}
+Vector;
+
+
+Vector  view;
+
+// The panning that pan_in_place reads
+int8_t  dx;
+int8_t  dy;
+
+// The world that the Makefile packs for unpack_row
+extern const uint8_t * const world_rows[];
+
+typedef void (*Routine)( void);
+
+char *name_of_scroll[] = {
+  "scroll_up",
+  "scroll_up_left",
+  "scroll_left",
+  "scroll_down_left",
+  "scroll_down",
+  "scroll_down_right",
+  "scroll_right",
+  "scroll_up_right",
+  "shift_a_to_b_up",
+  "shift_a_to_b_up_left",
+  "shift_a_to_b_left",
+  "shift_a_to_b_down_left",
+  "shift_a_to_b_down",
+  "shift_a_to_b_down_right",
+  "shift_a_to_b_right",
+  "shift_a_to_b_up_right",
+  "colour_up",
+  "colour_up_left",
+  "colour_left",
+  "colour_down_left",
+  "colour_down",
+  "colour_down_right",
+  "colour_right",
+  "colour_up_right",
+};
+Routine  scroll[] = {
+  scroll_up,
+  scroll_up_left,
+  scroll_left,
+  scroll_down_left,
+  scroll_down,
+  scroll_down_right,
+  scroll_right,
+  scroll_up_right,
+  shift_a_to_b_up,
+  shift_a_to_b_up_left,
+  shift_a_to_b_left,
+  shift_a_to_b_down_left,
+  shift_a_to_b_down,
+  shift_a_to_b_down_right,
+  shift_a_to_b_right,
+  shift_a_to_b_up_right,
+  colour_up,
+  colour_up_left,
+  colour_left,
+  colour_down_left,
+  colour_down,
+  colour_down_right,
+  colour_right,
+  colour_up_right,
+};
+
+
+// The raster IRQ handler of examples/8-way-tiles without DOUBLE_BUFFERED
+// before pan_in_place, without PRERENDER, COMPRESSED, REU or _RASTER_DEBUG.
+// raster-irq.S also saves cc65's zero-page registers around it, which is not
+// counted here
+//
+#define  WORLD_WIDTH_IN_CHARS   ( WORLD_WIDTH_IN_TILES << LOG2_TILE_PATTERN_WIDTH)
+#define  WORLD_HEIGHT_IN_CHARS  ( WORLD_HEIGHT_IN_TILES << LOG2_TILE_PATTERN_HEIGHT)
+#define  WORLD_ROW( y)  ( TILE_WITHIN_WORLD+ (y)* WORLD_WIDTH_IN_TILES)
+
+void render_edges( uint8_t *matrix, int8_t dx, int8_t dy )
+{
+  uint8_t  row_on_screen;
+  uint8_t  column_on_screen;
+  Vector   tile_within_world;
+
+  if ( dx )
+  {
+    column_on_screen = -1 == dx ? 0 : 39;
+    tile_within_world.y = view.y >> LOG2_TILE_PATTERN_HEIGHT;
+    tile_within_world.x = ( view.x +column_on_screen) >> LOG2_TILE_PATTERN_WIDTH;
+    tile_read_head = WORLD_ROW( tile_within_world.y)+ tile_within_world.x;
+    write_head = matrix + column_on_screen;
+    render_tiles_down( column_on_screen );
+  }
+  if ( dy )
+  {
+    row_on_screen = -1 == dy ? 0 : 24;
+    write_head = (0 == row_on_screen) ? matrix : matrix + 40* 24;
+    tile_within_world.y = ( view.y + row_on_screen) >> LOG2_TILE_PATTERN_HEIGHT;
+    tile_within_world.x = view.x >> LOG2_TILE_PATTERN_WIDTH;
+    tile_read_head = WORLD_ROW( tile_within_world.y)+ tile_within_world.x;
+    render_tiles_across( row_on_screen );
+  }
+}
+
+void pan( int8_t dx, int8_t dy )
+{
+  if ( dx < 0  &&  0 == view.x ) dx = 0;
+  if ( 0 < dx  &&  WORLD_WIDTH_IN_CHARS-40 == view.x ) dx = 0;
+  if ( dy < 0  &&  0 == view.y ) dy = 0;
+  if ( 0 < dy  &&  WORLD_HEIGHT_IN_CHARS-25 == view.y ) dy = 0;
+
+  if ( 0 == dx  &&  0 == dy) return;
+
+  view.x += dx;
+  view.y += dy;
+
+  switch (dy)
+  {
+  case -1:
+    switch(dx)
+    {
+    case -1: scroll_down_right(); break;
+    case  0: scroll_down(); break;
+    case +1: scroll_down_left(); break;
+    }
+    break;
+  case 0:
+    switch(dx)
+    {
+    case -1: scroll_right(); break;
+    case +1: scroll_left(); break;
+    }
+    break;
+  case +1:
+    switch(dx)
+    {
+    case -1: scroll_up_right(); break;
+    case  0: scroll_up(); break;
+    case +1: scroll_up_left(); break;
+    }
+    break;
+  }
+
+  render_edges( CHAR_MATRIX, dx, dy );
+}
+
+void pan_c( void)
+{
+  if ( dx || dy ) pan( dx, dy );
+  dx = 0;
+  dy = 0;
+}
+
+
+void init()
+{
+  int i,j;
+  for ( i = 0; i < 256; i ++)
+  {
+    for(j=0;j<16;j++)
+    TILE_PATTERN[ (i << LOG2_TILE_PATTERN_SIZE) + j] = i;
+  }
+  for ( i = 0;  i < WORLD_WIDTH_IN_TILES*WORLD_HEIGHT_IN_TILES;  i += 1 )
+    TILE_WITHIN_WORLD[ i] = i;
+
+  // Builds the tables of tile pattern addresses that the renderers use
+  asm_init();
+}
+
+
+int main( int argc, char *argv[] )
+{
+  bool     dry = 0 == strcmp( argv[1], "dry");
+  char    *routine = argv[2];
+  uint8_t  edge = atoi( argv[3]);
+  Vector   tile_within_world;
+  uint8_t  i;
+
+  view.x = atoi( argv[4]);
+  view.y = atoi( argv[5]);
+
+  init();
+
+  // The same set-up as pan() in examples/8-way-tiles/main.c
+  if ( 0 == strcmp( routine, "render_tiles_across") )
+  {
+    write_head = CHAR_MATRIX + 40* edge;
+    tile_within_world.y = ( view.y + edge) >> LOG2_TILE_PATTERN_HEIGHT;
+    tile_within_world.x = view.x >> LOG2_TILE_PATTERN_WIDTH;
+    tile_read_head = TILE_WITHIN_WORLD+ tile_within_world.y* WORLD_WIDTH_IN_TILES+ tile_within_world.x;
+    if ( ! dry )
+      render_tiles_across( edge);
+  }
+  else if ( 0 == strcmp( routine, "render_tiles_down") )
+  {
+    write_head = CHAR_MATRIX + edge;
+    tile_within_world.y = view.y >> LOG2_TILE_PATTERN_HEIGHT;
+    tile_within_world.x = ( view.x + edge) >> LOG2_TILE_PATTERN_WIDTH;
+    tile_read_head = TILE_WITHIN_WORLD+ tile_within_world.y* WORLD_WIDTH_IN_TILES+ tile_within_world.x;
+    if ( ! dry )
+      render_tiles_down( edge);
+  }
+  else if ( 0 == strcmp( routine, "unpack_row") )
+  {
+    tile_read_head = (uint8_t*)world_rows[ edge];
+    write_head = TILE_WITHIN_WORLD;
+    if ( ! dry )
+      unpack_row();
+  }
+  else if ( 0 == strcmp( routine, "pan_in_place")  ||  0 == strcmp( routine, "pan_c") )
+  {
+    int8_t  step = 6 < argc ? atoi( argv[6]) : 1;
+    dx = ( edge % 3- 1)* step;
+    dy = ( edge / 3- 1)* step;
+    if ( ! dry )
+    {
+      if ( 0 == strcmp( routine, "pan_in_place") )
+        pan_in_place();
+      else
+        pan_c();
+    }
+  }
+  else if ( 0 == strcmp( routine, "slice") )
+  {
+    if ( NULL == shift_a_to_b_slices[ edge][ view.x] )
+      return 1;
+    if ( ! dry )
+      shift_a_to_b_slices[ edge][ view.x]();
+  }
+  else
+  {
+    for ( i = 0;  i < sizeof(scroll) / sizeof(scroll[0]);  i += 1 )
+    {
+      if ( 0 == strcmp( routine, name_of_scroll[ i]) )
+        break;
+    }
+    if ( i == sizeof(scroll) / sizeof(scroll[0]) )
+      return 1;
+    if ( ! dry )
+      scroll[ i]();
+  }
+
+  return 0;
+}
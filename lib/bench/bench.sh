@@ -0,0 +1,219 @@
+#!/bin/sh
+#
+# Usage: bench.sh <directory of harnesses> <results.tsv> [ <baseline.tsv> ]
+#
+# Runs every case under sim65, prints the best and worst cycle counts of each
+# routine and writes them to <results.tsv>.  When a baseline is given, exits
+# with status 1 if any routine is missing from it or if the worst case of any
+# routine is slower than its baseline by more than $SLACK percent, by default
+# 1, which absorbs the few cycles that the harness spends passing parameters
+
+set -e
+
+BIN=$1
+RESULTS=$2
+BASELINE=$3
+SLACK=${SLACK:-1}
+
+# Cycles to add to each case that measure() appends, for work that sim65
+# cannot see
+dma=0
+
+CASES=$(mktemp)
+trap 'rm -f $CASES' EXIT
+
+
+# Prints the number of cycles that sim65 reports for a whole run, or fails if
+# the harness does not exit with status 0, as for a routine that it does not
+# know
+cycles()
+{
+  output=$(sim65 -c "$@" 2>&1) || {
+    echo "$*: sim65 exited with status $?" >&2
+    return 1
+  }
+  echo "$output" | awk '$2 == "cycles" { print $1 }'
+}
+
+
+# @param  $1  harness, e.g. "8-way-tiles"
+# @param  $2  routine, as reported
+# @param  $3  description of the case, e.g. "row 24 x&3=1 y&3=0"
+# @param  ..  arguments for the harness after "run" or "dry"
+#
+# Appends "<routine> <case> <cycles>" to $CASES where <cycles> is the cost of
+# the invocation of the routine alone
+measure()
+{
+  harness=$BIN/bench-$1
+  routine=$2
+  label=$3
+  shift 3
+  run=$(cycles $harness run "$@") || exit 1
+  dry=$(cycles $harness dry "$@") || exit 1
+  if [ -z "$run" ] || [ -z "$dry" ]; then
+    echo "$routine ( $label): sim65 did not report cycles" >&2
+    exit 1
+  fi
+  printf '%s\t%s\t%d\n' "$routine" "$label" $((run - dry + dma)) >> $CASES
+}
+
+
+for offset in -41 -40 -39 -1 +1 +39 +40 +41; do
+  measure 8-way-scroll coarse_scroll "offset $offset" coarse_scroll $offset
+done
+
+# sim65 has no REU, so add the cycles of the DMA: a byte per cycle, all of
+# the matrix in to the REU and all but |offset| cells back out
+for offset in -41 -40 -39 -1 +1 +39 +40 +41; do
+  dma=$((2000 - ${offset#[-+]}))
+  measure 8-way-scroll reu_shift "offset $offset" reu_shift $offset
+done
+dma=0
+
+# Steps of 2..4 cells each way, which pan() in examples/8-way-scroll takes to
+# shift_cells() rather than the speedcode
+for step in 2 3 4; do
+  for dy in -1 0 1; do
+    for dx in -1 0 1; do
+      if [ $dx != 0 ] || [ $dy != 0 ]; then
+        offset=$((40 * dy * step + dx * step))
+        measure 8-way-scroll shift_cells "offset $offset" shift_cells $offset
+      fi
+    done
+  done
+done
+
+# Each generator of the world filling the edges that pan() fills, from views
+# whose multiplications take few and many steps, against character_at()
+for generator in xor_world grid_world character_at; do
+  for view in "0 0" "255 255" "85 170" "170 85"; do
+    for row in 0 24; do
+      measure 8-way-scroll ${generator}_fill_row "row $row view $view" ${generator}_fill_row $row $view
+    done
+    for column in 0 39; do
+      measure 8-way-scroll ${generator}_fill_column "column $column view $view" ${generator}_fill_column $column $view
+    done
+  done
+done
+
+for direction in up up_left left down_left down down_right right up_right; do
+  measure 8-way-scroll speedcode_$direction "-" scroll_$direction
+done
+
+# The whole of pan() from examples/8-way-scroll with xor_world, by steps of 1..4
+# cells in each direction: one shift however far and every exposed row and
+# column filled
+for step in 1 2 3 4; do
+  for dy in -1 0 1; do
+    for dx in -1 0 1; do
+      if [ $dx != 0 ] || [ $dy != 0 ]; then
+        measure 8-way-scroll pan_step_$step "dx $((dx * step)) dy $((dy * step))" pan $((dx * step)) $((dy * step))
+      fi
+    done
+  done
+done
+
+for direction in up up_left left down_left down down_right right up_right; do
+  measure 8-way-tiles scroll_$direction "-" scroll_$direction 0 0 0
+done
+
+for direction in up up_left left down_left down down_right right up_right; do
+  measure 8-way-tiles shift_$direction "-" shift_a_to_b_$direction 0 0 0
+done
+
+for direction in up up_left left down_left down down_right right up_right; do
+  measure 8-way-tiles colour_$direction "-" colour_$direction 0 0 0
+done
+
+# Every slice that SMOOTH=1 copies per frame, by the index of the direction
+# in shift_a_to_b_slices.  Only those that do not expose a row have slice 6
+for direction in 0 1 2 3 5 6 7 8; do
+  for slice in 0 1 2 3 4 5; do
+    measure 8-way-tiles slice "direction $direction slice $slice" slice $direction $slice 0
+  done
+done
+for direction in 3 5; do
+  measure 8-way-tiles slice "direction $direction slice 6" slice $direction 6 0
+done
+
+# view starts at (4,4) so that every phase stays within the world
+for x in 0 1 2 3; do
+  for y in 0 1 2 3; do
+    for row in 0 24; do
+      measure 8-way-tiles render_tiles_across "row $row x&3=$x y&3=$y" render_tiles_across $row $((4 + x)) $((4 + y))
+    done
+    for column in 0 39; do
+      measure 8-way-tiles render_tiles_down "column $column x&3=$x y&3=$y" render_tiles_down $column $((4 + x)) $((4 + y))
+    done
+  done
+done
+
+# The whole of the raster IRQ handler without DOUBLE_BUFFERED, in every
+# direction from every phase of the view within a tile, against the C that it
+# replaced
+for routine in pan_in_place pan_c; do
+  for direction in 0 1 2 3 5 6 7 8; do
+    for phase in 0 1 2 3; do
+      measure 8-way-tiles $routine "direction $direction x&3=y&3=$phase" $routine $direction $((4 + phase)) $((4 + phase))
+    done
+  done
+done
+
+# And by steps of 2..4 cells at once, which pan_in_place shifts in one pass
+# with shift_cells() from lib/shift-cells.S
+for step in 2 3 4; do
+  for direction in 0 1 2 3 5 6 7 8; do
+    for phase in 0 1 2 3; do
+      measure 8-way-tiles pan_in_place_step_$step "direction $direction x&3=y&3=$phase" pan_in_place $direction $((4 + phase)) $((4 + phase)) $step
+    done
+  done
+done
+
+# A row of 256 tiles without runs, which is the most that unpack_row decodes
+measure 8-way-tiles unpack_row "256 tiles, no runs" unpack_row 0 0 0
+
+# Each tick of the song packed from music.score, through two loops of its
+# patterns, in which every voice reaches the end of a pattern every 5 ticks
+for tick in $(seq 0 20); do
+  measure music music_tick "tick $tick" $tick
+done
+
+
+# Reduce the cases to the best and worst of each routine, in the order that
+# the routines were first measured
+awk -F'\t' '
+  !( $1 in best ) {
+    order[ n++] = $1
+    best[ $1] = worst[ $1] = $3
+    best_case[ $1] = worst_case[ $1] = $2
+  }
+  $3 < best[ $1] { best[ $1] = $3; best_case[ $1] = $2 }
+  worst[ $1] < $3 { worst[ $1] = $3; worst_case[ $1] = $2 }
+  END {
+    print "# routine\tbest\tworst\tbest case\tworst case"
+    for ( i = 0;  i < n;  i += 1 ) {
+      r = order[ i]
+      printf "%s\t%d\t%d\t%s\t%s\n", r, best[ r], worst[ r], best_case[ r], worst_case[ r]
+    }
+  }' $CASES > $RESULTS
+
+awk -F'\t' '
+  BEGIN { printf "%-24s %8s %8s   %s\n", "routine", "best", "worst", "worst case" }
+  !/^#/ { printf "%-24s %8d %8d   %s\n", $1, $2, $3, $5 }' $RESULTS
+
+if [ -n "$BASELINE" ]; then
+  awk -F'\t' -v slack=$SLACK '
+    FNR == NR { if ( !/^#/ ) baseline[ $1] = $3; next }
+    /^#/ { next }
+    !( $1 in baseline ) {
+      printf "MISSING: %s has no baseline\n", $1
+      failed = 1
+      next
+    }
+    baseline[ $1] * ( 100 + slack) < $3 * 100 {
+      printf "REGRESSION: %s worst case is %d cycles, baseline is %d\n", $1, $3, baseline[ $1]
+      failed = 1
+    }
+    END { exit failed }' $BASELINE $RESULTS
+fi
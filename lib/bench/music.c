@@ -0,0 +1,38 @@
+/*
+
+Harness for timing music_tick() from lib/music-player.S under sim65:
+
+  bench-music <run|dry> <tick>
+
+plays the song that the Makefile packs from music.score for <tick> ticks and
+then times the next.  A "dry" run does everything except invoke that tick so
+that bench.sh can subtract the cost of starting up, setting up and exiting.
+sim65 has no SID, but music_tick() only writes the shadow of it in RAM
+
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "music.h"
+
+
+int main( int argc, char *argv[] )
+{
+  bool      dry = 0 == strcmp( argv[1], "dry");
+  uint16_t  tick = atoi( argv[2]);
+
+  music_init();
+  while ( 0 < tick )
+  {
+    music_tick();
+    tick -= 1;
+  }
+
+  if ( ! dry )
+    music_tick();
+
+  return 0;
+}
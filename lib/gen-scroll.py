@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""
+Generates unrolled speedcode ( ca65 source) that shifts the 40x25 character
+matrix by one cell in each of the eight directions, like the hand-written
+scroll_up() in examples/8-way-tiles.
+
+  gen-scroll.py [--from ADDR] [--to ADDR] [--prefix NAME] [--rows-per-pass N] [--slices] [--edges PAGE] > scroll.S
+
+The routines are named after the direction in which the characters move:
+scroll_up() moves every character up a row and so exposes the bottom row.
+The cells of the exposed row and column are not copied because the caller
+fills them in anyway.
+
+By default the matrix at $0400 is shifted in place.  Given a different --to,
+the shifted image of --from is written to --to instead, as required to build
+the back buffer of a double-buffered display.
+
+Each routine copies a column of --rows-per-pass cells per iteration of a loop
+that runs across the screen, and as many such loops as are required to cover
+all of the rows.  More rows per pass is faster but the code is larger.
+
+With --slices, each pass is a routine of its own, named after the direction
+and then numbered from 0, so that the shift may be spread over several frames.
+A table of their addresses, _<prefix>slices, is also generated.  It is
+indexed like a C array [9][slices] by 3* ( dy+ 1)+ dx+ 1, where dx and dy are
+the movement of the characters, and then by the number of the pass.  Entries
+for passes that a direction does not need are 0.
+
+With --edges, the exposed row and column are filled in from a page-aligned
+buffer rather than left alone: the top row at +$00, the bottom row at +$c0
+and the column at +$30, one byte per row.  $50..$77 and $80..$a7 are used to
+carry a row between passes.  The passes always run from the top of the screen
+down, so that, given few enough rows per pass, a routine started in the
+bottom border stays ahead of the raster.  This is meant for colour RAM, which
+cannot be double-buffered and so must be shifted in place as the screen flips.
+"""
+
+import argparse
+import sys
+
+
+COLUMNS = 40
+ROWS = 25
+
+# Name, and the movement of the characters across and down the screen
+DIRECTIONS = [
+  ( 'up',          0, -1 ),
+  ( 'up_left',    -1, -1 ),
+  ( 'left',       -1,  0 ),
+  ( 'down_left',  -1, +1 ),
+  ( 'down',        0, +1 ),
+  ( 'down_right', +1, +1 ),
+  ( 'right',      +1,  0 ),
+  ( 'up_right',   +1, -1 ),
+]
+
+LDA_ABS_X = 4  # +1 when the page is crossed
+STA_ABS_X = 5
+LDX_IMM = 2
+INX_DEX = 2
+CPX_IMM = 2
+BRANCH_NOT_TAKEN = 2
+BRANCH_TAKEN = 3  # +1 when the page is crossed, which is not known here
+JMP_ABS = 3
+RTS = 6
+LDA_ABS = 4
+STA_ABS = 4
+
+# Offsets within the edges page.  The rows are at the same offsets as the top
+# and bottom rows of a 1K-aligned screen so that a renderer can address them
+# with the low byte of its pointer in to the screen
+TOP_ROW = 0x00
+COLUMN = 0x30  # One byte per row
+CARRY = ( 0x50, 0x80 )
+BOTTOM_ROW = 0xc0
+
+
+def crosses_page( base, index ):
+  return ( base & 0xff00) != ( ( base + index) & 0xff00)
+
+
+class Routine:
+
+  # @param  only   The number of the pass to generate, or None for all of them
+  # @param  edges  The address of the edges page ( see --edges), or None
+  #
+  def __init__( self, name, dx, dy, src, dst, rows_per_pass, only = None, edges = None ):
+    self.name = name
+    self.lines = []
+    self.cycles = 0
+
+    # Cells that are exposed are in the row and column that the characters
+    # move away from.  They are not worth copying because the caller fills
+    # them in anyway, unless they are filled in from the edges page here
+    exposed_row = ROWS-1 if dy < 0 else 0 if 0 < dy else None
+    exposed_column = COLUMNS-1 if dx < 0 else 0 if 0 < dx else None
+    rows = [ r for r in range( ROWS) if edges is not None or r != exposed_row ]
+    first_column = 1 if 0 < dx else 0
+    columns = COLUMNS - ( 1 if dx else 0 )
+
+    # When shifting in place, a cell must be read before it is overwritten,
+    # so rows are copied in the direction opposite to the movement and so are
+    # the columns within each row.  With edges, the passes run from the top
+    # down regardless so as to stay ahead of the raster and the rows within
+    # each pass are ordered instead, which leaves only the last row of each
+    # pass to be carried over to the next when the characters move down
+    in_place = src == dst
+    downward = in_place and 0 < dy
+    if downward and edges is None:
+      rows.reverse()
+    ascending = in_place and dx < 0
+
+    passes = [ rows[ i:i+rows_per_pass] for i in range( 0, len( rows), rows_per_pass) ]
+    self.passes = len( passes)
+    for n, pass_rows in enumerate( passes):
+      if only is not None and n != only:
+        continue
+      moves = []
+      if edges is not None and downward:
+        # Save the last row of this pass for the next, alternating between
+        # the two carry buffers
+        if n + 1 < len( passes):
+          moves.append(( src + COLUMNS * pass_rows[-1] + first_column - dx, edges + CARRY[ n % 2] + first_column ))
+        pass_rows = list( reversed( pass_rows))
+      for r in pass_rows:
+        to = dst + COLUMNS * r + first_column
+        if r == exposed_row:
+          fro = edges + ( TOP_ROW if 0 == r else BOTTOM_ROW) + first_column
+        elif edges is not None and downward and 0 < n and r == pass_rows[-1]:
+          fro = edges + CARRY[ ( n - 1) % 2] + first_column
+        else:
+          fro = src + COLUMNS * ( r - dy) + first_column - dx
+        moves.append(( fro, to ))
+      self.copy( n, moves, columns, ascending )
+      if edges is not None and exposed_column is not None:
+        for r in sorted( pass_rows):
+          self.emit('lda $%04x' % ( edges + COLUMN + r))
+          self.emit('sta $%04x' % ( dst + COLUMNS * r + exposed_column))
+          self.cycles += LDA_ABS + STA_ABS
+    self.emit('rts')
+    self.cycles += RTS
+
+  def emit( self, instruction ):
+    self.lines.append( instruction)
+
+  # Emits a loop across the screen that copies each ( from, to) pair of
+  # addresses, indexed by X
+  #
+  def copy( self, n, moves, columns, ascending ):
+    loop = '@pass%d' % n
+    body = []
+    per_iteration = 0
+    for fro, to in moves:
+      body += [ 'lda $%04x,x' % fro, 'sta $%04x,x' % to ]
+      per_iteration += LDA_ABS_X + STA_ABS_X
+      self.cycles += sum( crosses_page( fro, x) for x in range( columns) )
+    self.cycles += LDX_IMM + columns * per_iteration
+
+    if ascending:
+      self.emit('ldx #$00')
+      self.emit( loop + ':')
+      self.lines += body
+      self.emit('inx')
+      self.emit('cpx #$%02x' % columns)
+      self.cycles += columns * ( INX_DEX + CPX_IMM)
+      fits = 3 * len( body) + 1 + 2 + 2 <= 128  # can the branch reach?
+      taken, done = 'bne', 'beq'
+    else:
+      self.emit('ldx #$%02x' % ( columns - 1))
+      self.emit( loop + ':')
+      self.lines += body
+      self.emit('dex')
+      self.cycles += columns * INX_DEX
+      fits = 3 * len( body) + 1 + 2 <= 128
+      taken, done = 'bpl', 'bmi'
+
+    if fits:
+      self.emit('%s %s' % ( taken, loop ))
+      self.cycles += ( columns - 1) * BRANCH_TAKEN + BRANCH_NOT_TAKEN
+    else:
+      # Out of reach of a branch, so hop over a JMP instead
+      self.emit('%s :+' % done)
+      self.emit('  jmp %s' % loop)
+      self.emit(':')
+      self.cycles += ( columns - 1) * ( BRANCH_NOT_TAKEN + JMP_ABS) + BRANCH_TAKEN
+
+  def source( self ):
+    out = [ '_%s:' % self.name ]
+    for line in self.lines:
+      out.append( line if line.endswith(':') and not line.startswith(' ') else '  ' + line )
+    return '\n'.join( out)
+
+
+def main():
+  parser = argparse.ArgumentParser( description = __doc__.strip().split('\n')[0] )
+  address = lambda s: int( s, 0)
+  parser.add_argument('--from', dest = 'src', type = address, default = 0x0400, help = 'address of the character matrix')
+  parser.add_argument('--to', dest = 'dst', type = address, help = 'address of the shifted matrix ( default: --from)')
+  parser.add_argument('--prefix', default = 'scroll_', help = 'of the names of the routines')
+  parser.add_argument('--rows-per-pass', type = int, default = 25, help = 'rows of cells copied per iteration ( 1..25)')
+  parser.add_argument('--slices', action = 'store_true', help = 'generate a routine for each pass, and a table of them')
+  parser.add_argument('--edges', type = address, help = 'address of the page from which to fill in the exposed cells')
+  args = parser.parse_args()
+  if not 1 <= args.rows_per_pass <= ROWS:
+    parser.error('--rows-per-pass must be 1..%d' % ROWS)
+
+  if args.dst is None:
+    args.dst = args.src
+  if args.edges is not None and args.edges & 0xff:
+    parser.error('--edges must be page-aligned')
+
+  routines = [ Routine( args.prefix + name, dx, dy, args.src, args.dst, args.rows_per_pass, edges = args.edges ) for name, dx, dy in DIRECTIONS ]
+
+  table = None
+  if args.slices:
+    most = ( ROWS + args.rows_per_pass - 1) // args.rows_per_pass
+    table = [ [ '0'] * most for _ in range( 9) ]
+    whole = routines
+    routines = []
+    for ( name, dx, dy ), r in zip( DIRECTIONS, whole):
+      for n in range( r.passes):
+        routines.append( Routine( '%s%s_%d' % ( args.prefix, name, n ), dx, dy, args.src, args.dst, args.rows_per_pass, n, args.edges ))
+        table[ 3 * ( dy + 1) + dx + 1][ n] = '_' + routines[-1].name
+
+  print('; Generated by %s.  Do not edit' % ' '.join( [ 'gen-scroll.py'] + sys.argv[1:] ))
+  print()
+  for r in routines:
+    print('.export _%s' % r.name)
+  if table:
+    print('.export _%sslices' % args.prefix)
+  print()
+  if table:
+    print()
+    print('_%sslices:' % args.prefix)
+    for entries in table:
+      print('  .addr ' + ', '.join( entries))
+    print()
+  for r in routines:
+    print()
+    print('; %d cycles, plus 1 for each taken branch that crosses a page' % r.cycles)
+    print( r.source())
+  print()
+
+
+if __name__ == '__main__':
+  main()
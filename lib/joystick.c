@@ -3,8 +3,61 @@
 #include <c64.h>
 
 
+// The queue of events, which joystick-sample.S writes at joy_event_head and
+// joy_next_event() reads at joy_event_tail
+extern uint8_t  joy_event_frame[ JOY_EVENTS];
+extern uint8_t  joy_event_port[ JOY_EVENTS];
+extern uint8_t  joy_event_pressed[ JOY_EVENTS];
+extern uint8_t  joy_event_released[ JOY_EVENTS];
+extern volatile uint8_t  joy_event_head;
+extern uint8_t  joy_event_tail;
+
+
 uint8_t joy_read()
 {
   return CIA1.pra;
 }
 
+
+uint8_t __fastcall__ joy_read_port( uint8_t port )
+{
+  uint8_t  columns;
+  uint8_t  state;
+
+  if ( JOY_PORT_2 == port )
+    return CIA1.pra;
+
+  // The keyboard columns are port A, which the KERNAL's keyboard scan also
+  // writes, so keep its IRQ out until they are put back.  The flags are put
+  // back rather than interrupts enabled, in case this is called from a raster
+  // handler or with interrupts off
+  __asm__( "php");
+  __asm__( "sei");
+  columns = CIA1.pra;
+  CIA1.pra = 0xff;
+  state = CIA1.prb;
+  CIA1.pra = columns;
+  __asm__( "plp");
+
+  return state;
+}
+
+
+bool __fastcall__ joy_next_event( JoyEvent *event )
+{
+  uint8_t  tail = joy_event_tail;
+
+  if ( tail == joy_event_head )
+    return false;
+
+  event->frame = joy_event_frame[ tail];
+  event->port = joy_event_port[ tail];
+  event->pressed = joy_event_pressed[ tail];
+  event->released = joy_event_released[ tail];
+
+  // Only now may joy_sample() write over the event
+  joy_event_tail = ( tail + 1) & ( JOY_EVENTS - 1);
+
+  return true;
+}
+
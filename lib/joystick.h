@@ -1,12 +1,15 @@
-
 #ifndef __JOYSTICK_H
 #define __JOYSTICK_H
 
 
+#include <stdbool.h>
 #include <stdint.h>
 
 
-/* Intended to be like cc65 joystick support but only support Joystick#2 on the C64 */
+/* Intended to be like cc65 joystick support.  Reads Joystick #1 and #2 on the
+   C64, either straight away or as sampled once per frame by joy_sample() from
+   the raster IRQ, which also notes which directions and buttons have been
+   pressed and released since the sample before and queues them as events */
 
 #define  JOY_UP     0
 #define  JOY_DOWN   1
@@ -20,10 +23,62 @@
 #define  JOY_BTN_RIGHT(v)  ( ((v) & (1 << JOY_RIGHT)) == 0 )
 #define  JOY_BTN_FIRE(v)   ( ((v) & (1 << JOY_FIRE)) == 0 )
 
+// The bits of joy_pressed, joy_released and the masks of a JoyEvent, which
+// unlike the state that joy_read() provides are 1 for held
+#define  JOY_MASK_UP     ( 1 << JOY_UP)
+#define  JOY_MASK_DOWN   ( 1 << JOY_DOWN)
+#define  JOY_MASK_LEFT   ( 1 << JOY_LEFT)
+#define  JOY_MASK_RIGHT  ( 1 << JOY_RIGHT)
+#define  JOY_MASK_FIRE   ( 1 << JOY_FIRE)
+#define  JOY_MASK        0x1f
+
+// The index of each port in joy_sampled and so on
+#define  JOY_PORT_1  0
+#define  JOY_PORT_2  1
+
+// The events that can be queued before joy_next_event() is invoked.  A power
+// of 2
+#define  JOY_EVENTS  16
+
+typedef struct
+{
+  uint8_t  frame;     // joy_frame when it was sampled
+  uint8_t  port;      // JOY_PORT_1 or JOY_PORT_2
+  uint8_t  pressed;   // JOY_MASK_* bits that went from released to held
+  uint8_t  released;  // ..and from held to released
+}
+JoyEvent;
+
 
 // Provides the current state of Joystick #2
 extern  uint8_t  joy_read();
 
+// Provides the current state of the Joystick at JOY_PORT_1 or JOY_PORT_2, as
+// joy_read().  Joystick #1 shares its lines with the keyboard, which is why
+// no keyboard column is selected while it is read
+extern  uint8_t __fastcall__  joy_read_port( uint8_t port );
+
+// See joystick-sample.S.  The state of each port as at the last sample, as
+// joy_read() provides it, so for the JOY_BTN_* macros
+extern volatile uint8_t  joy_sampled[ 2];
+// The JOY_MASK_* bits of each port that went from released to held at the
+// last sample, and from held to released
+extern volatile uint8_t  joy_pressed[ 2];
+extern volatile uint8_t  joy_released[ 2];
+// Counts the samples, so frames when joy_sample() runs once per frame
+extern volatile uint8_t  joy_frame;
+
+// A handler for raster_add_asm() that samples both ports, once per frame.
+// Whenever either changes, an event is queued for joy_next_event().  If the
+// queue is full then the event is lost, although joy_sampled still follows the
+// joystick.  Costs about 210 cycles, and 60 more for each port that changes
+extern void  joy_sample( void);
+
+// Takes the oldest queued event in to event and returns true, or returns false
+// if there is none.  Game logic that reads the joystick this way does not have
+// to spin on it in case a tap comes and goes between reads
+extern bool __fastcall__  joy_next_event( JoyEvent *event );
+
 
 #endif
 
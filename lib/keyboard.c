@@ -0,0 +1,26 @@
+
+#include "keyboard.h"
+
+
+// The queue of events, which keyboard-scan.S writes at key_event_head and
+// key_next_event() reads at key_event_tail
+extern uint8_t  key_events[ KEY_EVENTS];
+extern volatile uint8_t  key_event_head;
+extern uint8_t  key_event_tail;
+
+
+bool __fastcall__ key_next_event( uint8_t *event )
+{
+  uint8_t  tail = key_event_tail;
+
+  if ( tail == key_event_head )
+    return false;
+
+  *event = key_events[ tail];
+
+  // Only now may key_scan() write over the event
+  key_event_tail = ( tail + 1) & ( KEY_EVENTS - 1);
+
+  return true;
+}
+
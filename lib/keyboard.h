@@ -0,0 +1,122 @@
+#ifndef __KEYBOARD_H
+#define __KEYBOARD_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/* Scans the keyboard from the raster IRQ rather than relying upon the
+   KERNAL's scan, which needs the CIA#1 IRQ.  Every key is scanned each frame in
+   to a bitmap, so any number may be held at once, and each press and release
+   is queued as an event */
+
+// The scan code of each key, 8* the column ( the bit of CIA#1 port A that
+// selects it) + the row ( the bit of port B that reads it).  These are the
+// codes that the KERNAL uses too.  RESTORE is not part of the matrix
+#define  KEY_DEL            0
+#define  KEY_RETURN         1
+#define  KEY_CRSR_RIGHT     2
+#define  KEY_F7             3
+#define  KEY_F1             4
+#define  KEY_F3             5
+#define  KEY_F5             6
+#define  KEY_CRSR_DOWN      7
+#define  KEY_3              8
+#define  KEY_W              9
+#define  KEY_A             10
+#define  KEY_4             11
+#define  KEY_Z             12
+#define  KEY_S             13
+#define  KEY_E             14
+#define  KEY_LEFT_SHIFT    15
+#define  KEY_5             16
+#define  KEY_R             17
+#define  KEY_D             18
+#define  KEY_6             19
+#define  KEY_C             20
+#define  KEY_F             21
+#define  KEY_T             22
+#define  KEY_X             23
+#define  KEY_7             24
+#define  KEY_Y             25
+#define  KEY_G             26
+#define  KEY_8             27
+#define  KEY_B             28
+#define  KEY_H             29
+#define  KEY_U             30
+#define  KEY_V             31
+#define  KEY_9             32
+#define  KEY_I             33
+#define  KEY_J             34
+#define  KEY_0             35
+#define  KEY_M             36
+#define  KEY_K             37
+#define  KEY_O             38
+#define  KEY_N             39
+#define  KEY_PLUS          40
+#define  KEY_P             41
+#define  KEY_L             42
+#define  KEY_MINUS         43
+#define  KEY_PERIOD        44
+#define  KEY_COLON         45
+#define  KEY_AT            46
+#define  KEY_COMMA         47
+#define  KEY_POUND         48
+#define  KEY_ASTERISK      49
+#define  KEY_SEMICOLON     50
+#define  KEY_HOME          51
+#define  KEY_RIGHT_SHIFT   52
+#define  KEY_EQUALS        53
+#define  KEY_UP_ARROW      54
+#define  KEY_SLASH         55
+#define  KEY_1             56
+#define  KEY_LEFT_ARROW    57
+#define  KEY_CTRL          58
+#define  KEY_2             59
+#define  KEY_SPACE         60
+#define  KEY_COMMODORE     61
+#define  KEY_Q             62
+#define  KEY_RUN_STOP      63
+
+// Set in an event for a release rather than a press
+#define  KEY_RELEASED  0x80
+
+// The events that can be queued before key_next_event() is invoked.  A power
+// of 2
+#define  KEY_EVENTS  16
+
+
+// Which keys are held as at the last scan, a byte per column and a bit per
+// row, 1 for held
+extern volatile uint8_t  key_matrix[ 8];
+
+#define  KEY_HELD( code)  ( key_matrix[ (code) >> 3] & ( 1 << ( (code) & 7)) )
+#define  KEY_SHIFTED()    ( KEY_HELD( KEY_LEFT_SHIFT)  ||  KEY_HELD( KEY_RIGHT_SHIFT) )
+
+// The rows that read as held at the last scan with no column selected, which
+// is Joystick #1, or a key in a column that Joystick #2 holds low.  The keys of
+// these rows could not be told apart from the joystick, so they are left as
+// they were in key_matrix until it is let go, rather than seen as held
+extern volatile uint8_t  key_ghosted;
+
+// Counts the scans, so frames when key_scan() runs once per frame
+extern volatile uint8_t  key_frame;
+
+// See keyboard-scan.S.  A handler for raster_add_asm() that scans the
+// keyboard, once per frame.  Each key that is pressed or released since the
+// scan before is queued for key_next_event().  If the queue is full then the
+// event is lost, although key_matrix still follows the keyboard.  Costs 530
+// cycles, and up to 250 more for each column in which a key changes.  Port A
+// of CIA#1 is put back as it was, so it may be used alongside joy_read() and
+// joy_sample()
+extern void  key_scan( void);
+
+// Takes the oldest queued event, which is the scan code of the key, with
+// KEY_RELEASED for a release, in to event and returns true, or returns false if
+// there is none
+extern bool __fastcall__  key_next_event( uint8_t *event );
+
+
+#endif
+
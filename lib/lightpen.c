@@ -0,0 +1,43 @@
+
+#include "lightpen.h"
+
+
+// Where a sprite must be for its top-left pixel to be on the top-left pixel of
+// the screen, which is where the VIC counts the light pen from too
+#define  SPRITE_X_LEFT  24
+#define  SPRITE_Y_TOP   50
+
+
+int8_t  lightpen_offset_x = 0;
+int8_t  lightpen_offset_y = 0;
+
+// The queue of events, which lightpen-sample.S writes at lightpen_event_head
+// and lightpen_next_event() reads at lightpen_event_tail.  X is in pixels
+// from the left of the sprite coordinates
+extern uint8_t  lightpen_events_frame[ LIGHTPEN_EVENTS];
+extern uint8_t  lightpen_events_x_lo[ LIGHTPEN_EVENTS];
+extern uint8_t  lightpen_events_x_hi[ LIGHTPEN_EVENTS];
+extern uint8_t  lightpen_events_y[ LIGHTPEN_EVENTS];
+extern uint8_t  lightpen_events_flags[ LIGHTPEN_EVENTS];
+extern volatile uint8_t  lightpen_event_head;
+extern uint8_t  lightpen_event_tail;
+
+
+bool __fastcall__ lightpen_next_event( LightpenEvent *event )
+{
+  uint8_t  tail = lightpen_event_tail;
+
+  if ( tail == lightpen_event_head )
+    return false;
+
+  event->frame = lightpen_events_frame[ tail];
+  event->flags = lightpen_events_flags[ tail];
+  event->x = ( lightpen_events_x_hi[ tail] << 8 | lightpen_events_x_lo[ tail])- SPRITE_X_LEFT+ lightpen_offset_x;
+  event->y = lightpen_events_y[ tail]- SPRITE_Y_TOP+ lightpen_offset_y;
+
+  // Only now may lightpen_sample() write over the event
+  lightpen_event_tail = ( tail + 1) & ( LIGHTPEN_EVENTS - 1);
+
+  return true;
+}
+
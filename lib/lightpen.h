@@ -0,0 +1,75 @@
+#ifndef __LIGHTPEN_H
+#define __LIGHTPEN_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/* Reads a light pen or light gun in port #1 from the raster IRQ: a sample per
+   frame, of which those too far from the rest are rejected and the rest
+   averaged, and the presses and releases of its trigger, all queued for the
+   main loop */
+
+// The bits of the flags of a LightpenEvent
+#define  LIGHTPEN_AIMED     0x01  // x and y are from a sample this frame
+#define  LIGHTPEN_PRESSED   0x02  // The trigger was pressed this frame
+#define  LIGHTPEN_RELEASED  0x04  // ..or released
+#define  LIGHTPEN_HELD      0x08  // The trigger is held
+
+// The events that can be queued before lightpen_next_event() is invoked.  A
+// power of 2
+#define  LIGHTPEN_EVENTS  8
+
+typedef struct
+{
+  uint8_t  frame;  // lightpen_frame when it was sampled
+  uint8_t  flags;  // LIGHTPEN_*
+  // The average of the samples, in pixels from the top-left of the screen and
+  // so negative or beyond 319 and 199 in the border.  As at the last sample
+  // unless LIGHTPEN_AIMED
+  int16_t  x;
+  int16_t  y;
+}
+LightpenEvent;
+
+
+// How many samples are averaged, as a power of 2: 0..3 for 1..8 samples.  2
+// to begin with.  More are steadier but lag further behind the pen
+extern uint8_t  lightpen_window_log2;
+
+// How far a sample may be from the average before it is rejected, in lines and
+// in units of 2 pixels across, as $d013 is.  8 to begin with.  After 3 rejects
+// in a row, the pen is taken to have moved there and averaging starts again
+// from the sample
+extern uint8_t  lightpen_tolerance;
+
+// The bits of CIA#1 port B, the lines of port #1, that the trigger pulls low.
+// Light guns differ.  Bit 0, up, to begin with.  The fire line is the light
+// pen line itself
+extern uint8_t  lightpen_trigger;
+
+// Added to the x and y of each event, to make up for how late a pen or gun
+// sees the beam
+extern int8_t  lightpen_offset_x;
+extern int8_t  lightpen_offset_y;
+
+// Counts the samples, so frames when lightpen_sample() runs once per frame
+extern volatile uint8_t  lightpen_frame;
+
+// See lightpen-sample.S.  A handler for raster_add_asm() that takes the
+// position that the VIC latched this frame, if any, and reads the trigger.  An
+// event is queued for lightpen_next_event() whenever a sample is accepted or
+// the trigger is pressed or released.  If the queue is full then the event is
+// lost.  Add it at a line below the screen, such as 250, so that the sample is
+// of this frame.  The light pen IRQ must stay disabled in VIC.imr.  Costs about
+// 170 cycles, and up to 650 when a sample is accepted
+extern void  lightpen_sample( void);
+
+// Takes the oldest queued event in to event and returns true, or returns false
+// if there is none
+extern bool __fastcall__  lightpen_next_event( LightpenEvent *event );
+
+
+#endif
+
@@ -0,0 +1,125 @@
+#include "modulation.h"
+#include "sid.h"
+
+
+// The registers, from $d400, of the destinations that are not of a voice
+#define  FLT_LO  21
+#define  FLT_HI  22
+#define  AMP     24
+
+
+static uint8_t  register_of( uint8_t destination, uint8_t offset )
+{
+  switch ( destination)
+  {
+    case MOD_TO_CUTOFF:  return FLT_LO;
+    case MOD_TO_VOLUME:  return AMP;
+    default:             return offset;
+  }
+}
+
+
+// @return  The value of the destination as it is in the shadow of the SID
+//
+static uint16_t  read( uint8_t destination, uint8_t offset )
+{
+  switch ( destination)
+  {
+    case MOD_TO_FREQ:
+      return (uint16_t)sid_shadow[ offset+1] << 8 | sid_shadow[ offset];
+
+    case MOD_TO_PW:
+      return (uint16_t)( sid_shadow[ offset+1] & 0xf) << 8 | sid_shadow[ offset];
+
+    case MOD_TO_CUTOFF:
+      return (uint16_t)sid_shadow[ FLT_HI] << 3 | sid_shadow[ FLT_LO] & 0x7;
+
+    default:
+      return sid_shadow[ AMP] & 0xf;
+  }
+}
+
+
+static void  write( uint8_t destination, uint8_t offset, uint16_t value )
+{
+  switch ( destination)
+  {
+    case MOD_TO_FREQ:
+    case MOD_TO_PW:
+      sid_write( offset, value & 0xff );
+      sid_write( offset+1, value >> 8 );
+      break;
+
+    case MOD_TO_CUTOFF:
+      sid_write( FLT_LO, value & 0x7 );
+      sid_write( FLT_HI, value >> 3 );
+      break;
+
+    default:
+      sid_write( AMP, sid_shadow[ AMP] & 0xf0 | value );
+  }
+}
+
+
+void  mod_connect( uint8_t slot, uint8_t source, uint8_t destination, uint8_t offset, int8_t depth )
+{
+  mod_disconnect( slot);
+  // The raster IRQ leaves a slot that is MOD_OFF alone, so it is connected last
+  offset = register_of( destination, offset);
+  mod_destination[ slot] = destination;
+  mod_offset[ slot] = offset;
+  mod_depth[ slot] = depth;
+  mod_base[ slot] = read( destination, offset);
+  mod_source[ slot] = source;
+}
+
+
+void __fastcall__  mod_disconnect( uint8_t slot )
+{
+  if ( MOD_OFF == mod_source[ slot] )
+    return;
+  mod_source[ slot] = MOD_OFF;
+  write( mod_destination[ slot], mod_offset[ slot], mod_base[ slot] );
+}
+
+
+void __fastcall__  mod_set_base( uint8_t slot, uint16_t base )
+{
+  // As for mod_connect(), the slot is left alone by the raster IRQ whilst the
+  // two bytes of the base are written
+  uint8_t  source = mod_source[ slot];
+  mod_source[ slot] = MOD_OFF;
+  mod_base[ slot] = base;
+  mod_source[ slot] = source;
+}
+
+
+uint8_t __fastcall__  mod_slot_of( uint8_t destination, uint8_t offset )
+{
+  uint8_t  slot;
+
+  offset = register_of( destination, offset);
+  for ( slot = 0;  slot < MOD_SLOTS;  slot += 1 )
+  {
+    if ( MOD_OFF != mod_source[ slot]  &&  destination == mod_destination[ slot]  &&  offset == mod_offset[ slot] )
+      break;
+  }
+  return slot;
+}
+
+
+void  mod_set_lfo_rate( uint8_t lfo, uint16_t rate )
+{
+  // Two bytes, so the raster IRQ is held off whilst they are written.  From
+  // a raster handler too, so the flags are put back rather than CLI
+  __asm__( "php");
+  __asm__( "sei");
+  mod_lfo_rate[ lfo] = rate;
+  __asm__( "plp");
+}
+
+
+void  mod_trigger( void)
+{
+  mod_envelope_state = MOD_ATTACK;
+}
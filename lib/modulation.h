@@ -0,0 +1,106 @@
+#ifndef __MODULATION_H
+#define __MODULATION_H
+
+
+#include <stdint.h>
+
+
+/* A modulation matrix for the SID, run once per frame from the raster IRQ:
+   each of MOD_SLOTS slots connects a source, such as an LFO or voice 3's
+   oscillator, to a destination, such as a voice's frequency or the filter
+   cutoff, so that the destination is its base plus the source times the depth
+   of the slot.  Destinations are written to the shadow of the SID in sid.h,
+   which sid_flush() then writes out, and so may be any of the four below for
+   any voice */
+
+#define  MOD_SLOTS  4
+
+// Sources, each -128..127 or, for the envelopes, 0..127
+#define  MOD_OFF        0  // The slot is not connected
+#define  MOD_LFO_1      1  // Software LFOs, see mod_lfo_rate and mod_lfo_shape
+#define  MOD_LFO_2      2
+#define  MOD_ENVELOPE   3  // A software envelope, see mod_trigger()
+#define  MOD_OSC3       4  // The top 8 bits of voice 3's oscillator, $d41b
+#define  MOD_ENV3       5  // Voice 3's envelope, $d41c / 2
+#define  MOD_SOURCES    6
+
+// Destinations and the units that source* depth is in, from which a
+// destination goes no further than its range
+#define  MOD_TO_FREQ    0  // A voice's frequency, 1s
+#define  MOD_TO_PW      1  // A voice's pulse width, 4s, 0..$fff
+#define  MOD_TO_CUTOFF  2  // The filter cutoff, 8s, 0..$7ff as shown by sid-intro
+#define  MOD_TO_VOLUME  3  // The volume, 1024s, 0..15
+#define  MOD_DESTINATIONS  4
+
+// The shapes of an LFO
+#define  MOD_TRIANGLE  0
+#define  MOD_SAWTOOTH  1
+#define  MOD_SQUARE    2
+#define  MOD_SHAPES    3
+
+// The states of the envelope
+#define  MOD_IDLE    0
+#define  MOD_ATTACK  1
+#define  MOD_DECAY   2
+
+
+// Each slot.  Use mod_connect() and mod_disconnect() rather than writing these
+// directly, since the raster IRQ may be reading them, except for the depth and
+// the source of a connected slot, which are a byte each
+extern uint8_t   mod_source[ MOD_SLOTS];       // MOD_OFF or the source
+extern uint8_t   mod_destination[ MOD_SLOTS];  // MOD_TO_*
+extern uint8_t   mod_offset[ MOD_SLOTS];       // Of its register from $d400
+extern int8_t    mod_depth[ MOD_SLOTS];
+extern uint16_t  mod_base[ MOD_SLOTS];         // See mod_set_base()
+
+// The value of each source as at the last tick, by MOD_*
+extern volatile int8_t  mod_value[ MOD_SOURCES];
+
+// What each LFO's phase moves on by per frame, of 65536 for a whole cycle.
+// $0100 and $0040 to begin with, cycles of 5.1 and 20.5 seconds.  See
+// mod_set_lfo_rate()
+extern uint16_t  mod_lfo_rate[ 2];
+extern uint8_t   mod_lfo_shape[ 2];  // MOD_TRIANGLE to begin with
+
+// What the envelope rises by per frame when triggered, to 127, and then falls
+// by, back to 0.  1..127 each.  8 and 2 to begin with
+extern uint8_t  mod_envelope_attack;
+extern uint8_t  mod_envelope_decay;
+extern volatile uint8_t  mod_envelope_state;  // MOD_IDLE, MOD_ATTACK or MOD_DECAY
+
+
+// Connects source to the register at offset from $d400 in slot, whose base is
+// then what the register is now in the shadow of the SID.  For MOD_TO_CUTOFF
+// and MOD_TO_VOLUME, offset is ignored.  Whatever was connected in slot is
+// disconnected first
+extern void  mod_connect( uint8_t slot, uint8_t source, uint8_t destination, uint8_t offset, int8_t depth );
+
+// Puts the destination of slot back to its base and leaves it be
+extern void __fastcall__  mod_disconnect( uint8_t slot );
+
+// Changes the base of slot, so that the destination may be changed whilst it
+// is being modulated
+extern void __fastcall__  mod_set_base( uint8_t slot, uint16_t base );
+
+// Returns the first connected slot whose destination is the register at offset
+// from $d400, as for mod_connect(), or MOD_SLOTS if there is none
+extern uint8_t __fastcall__  mod_slot_of( uint8_t destination, uint8_t offset );
+
+// Changes the rate of LFO 0 or 1 between ticks
+extern void  mod_set_lfo_rate( uint8_t lfo, uint16_t rate );
+
+// Starts the envelope rising from where it is
+extern void  mod_trigger( void);
+
+// See modulation-tick.S.  A handler for raster_add_asm() that moves each
+// source on and sets each connected destination.  Add it before sid_flush(),
+// at the same line, so that what it writes to the shadow reaches the SID in
+// the same frame, and after anything else that writes the destinations, such
+// as music_tick(), so that it has the last word.  Does nothing in a frame in
+// which video_skip is set, see video.h, so add video_pace() before it.  The
+// work does not depend on the sources or the depths: costs about 250 cycles
+// and no more than 450 more for each connected slot, so 2000 at most
+extern void  mod_tick( void);
+
+
+#endif
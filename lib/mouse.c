@@ -0,0 +1,37 @@
+
+#include "mouse.h"
+#include <c64.h>
+
+
+// See mouse-sample.S
+extern uint8_t  mouse_sprite;
+extern uint8_t  mouse_select;
+extern uint8_t  mouse_button_register;
+extern volatile uint8_t  mouse_fresh;
+
+
+void __fastcall__ mouse_init( uint8_t port, uint8_t sprite )
+{
+  // Keep the raster IRQ out until all of it is changed, and then put the flags
+  // back as they were
+  __asm__( "php");
+  __asm__( "sei");
+
+  mouse_sprite = sprite;
+
+  // Bit 6 of port A selects the pots of port #1 and bit 7 those of port #2.
+  // The rest deselect the keyboard columns.  The buttons of port #1 are read
+  // from port B and those of port #2 from port A
+  mouse_select = MOUSE_PORT_1 == port ? 0x7f : 0xbf;
+  mouse_button_register = MOUSE_PORT_1 == port ? 1 : 0;
+  CIA1.pra = mouse_select;
+
+  // The SID may be part-way through reading the other port's pots, so the
+  // first two samples only note where the mouse is
+  mouse_fresh = 2;
+
+  VIC.spr_ena |= 1 << sprite;
+
+  __asm__( "plp");
+}
+
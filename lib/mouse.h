@@ -0,0 +1,61 @@
+#ifndef __MOUSE_H
+#define __MOUSE_H
+
+
+#include <stdint.h>
+
+
+/* Drives a 1351 mouse from the raster IRQ, which samples it once per frame and
+   moves a sprite as the pointer, so that the main loop does not have to poll
+   it */
+
+// The ports, as for joystick.h
+#define  MOUSE_PORT_1  0
+#define  MOUSE_PORT_2  1
+
+// The bits of mouse_buttons, 1 for held
+#define  MOUSE_BTN_LEFT   0x01
+#define  MOUSE_BTN_RIGHT  0x02
+
+// The fractions of a pixel that the pointer is moved in
+#define  MOUSE_SUB_PIXELS  16
+
+
+// Where the pointer is, in pixels from the top-left of the screen, 0..319 and
+// 0..199.  The sprite's top-left pixel is put there
+extern volatile uint16_t  mouse_x;
+extern volatile uint16_t  mouse_y;
+
+// The MOUSE_BTN_* buttons that were held at the last sample
+extern volatile uint8_t  mouse_buttons;
+
+// How far the pointer moves for each count of the mouse, in 16ths of a pixel.
+// 16 to begin with, which is a pixel per count
+extern uint8_t  mouse_gain;
+
+// How much further the pointer moves per count for each count that the mouse
+// moves in a frame, in 16ths of a pixel, so that it crosses the screen quickly
+// when flicked but can still be placed exactly when moved slowly.  The gain
+// and acceleration together go no further than 255.  0 to begin with, which is
+// no acceleration
+extern uint8_t  mouse_acceleration;
+
+// Selects the pots of the mouse's port, at MOUSE_PORT_1 or MOUSE_PORT_2, and
+// the sprite ( 0..7) that is the pointer, which is enabled and put at the
+// top-left.  Its shape and colour are left to the caller.  Then add
+// mouse_sample() to the raster IRQ
+extern void __fastcall__  mouse_init( uint8_t port, uint8_t sprite );
+
+// See mouse-sample.S.  A handler for raster_add_asm() that samples the mouse,
+// once per frame, moves the pointer and reads the buttons.  It leaves CIA#1
+// port A selecting the pots of the mouse's port, which the SID takes 512
+// cycles to read, so the KERNAL's keyboard scan, which writes port A, must not
+// be chained by raster_init(), and any other handler that writes port A, such
+// as key_scan() or joy_sample(), which put it back, should run at least a
+// dozen lines before this one.  Costs about 340 cycles, and 460 more for each
+// axis along which the mouse moved
+extern void  mouse_sample( void);
+
+
+#endif
+
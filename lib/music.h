@@ -0,0 +1,42 @@
+#ifndef __MUSIC_H
+#define __MUSIC_H
+
+
+#include <stdint.h>
+
+
+/* Plays a song, packed from a text score by lib/pack-music.py, on the three
+   voices of the SID.  A tick per frame from the raster IRQ reads the patterns
+   of each voice and runs the pulse width and filter tables, and writes only
+   to the shadow of the SID in sid.h, which sid_flush() then writes out.  See
+   music-player.S for the format */
+
+// The most bytes of its pattern that a voice reads per tick, which bounds the
+// cost of a tick.  pack-music.py puts no more than a duration and an
+// instrument before each note, so a voice reaches its next note within a tick
+// even at the end of a pattern
+#define  MUSIC_MAX_READS  4
+
+
+// Non-zero whilst a song is playing
+extern volatile uint8_t  music_playing;
+
+
+// Starts the song that is linked in from the beginning
+extern void  music_init( void);
+
+// Stops playing and lets each voice's note go, from the next sid_flush()
+extern void  music_stop( void);
+
+// See music-player.S.  A handler for raster_add_asm() that plays a frame of
+// the song.  Add it before sid_flush(), at the same line, so that what it
+// writes to the shadow reaches the SID in the same frame.  A note is gated off
+// for its last frame so that the next can gate on again, unless it is only a
+// frame long.  Does nothing in a frame in which video_skip is set, see
+// video.h, so that the tempo is the same on NTSC as on PAL.  make bench in
+// lib/bench measures it as music_tick, up to the worst case in which all three
+// voices start a note after the end of a pattern
+extern void  music_tick( void);
+
+
+#endif
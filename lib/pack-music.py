@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""
+Packs a song written as a text score ( ca65 source) for the player in
+lib/music-player.S.
+
+  pack-music.py SCORE > song.S
+
+The score is a line per definition.  A line that begins with white space
+carries on the one before, and ; begins a comment:
+
+  speed 3
+      The frames per step that the lengths of notes are in.  1 unless given.
+      Applies to the patterns after it
+
+  instrument NAME ad=HH sr=HH wave=W [pw=H] [pulse=TABLE] [filter=TABLE]
+             [resonance=H] [mode=M]
+      W is triangle, sawtooth, pulse or noise, with +ring and/or +sync.  pw is
+      the pulse width / 256 that each note starts with, 8 unless given.  A
+      note of an instrument with a filter table is filtered, with that
+      resonance, 0..f, and M, low, band and/or high joined with +
+
+  pulse NAME ROW, ROW, ..
+  filter NAME ROW, ROW, ..
+      A table that changes the pulse width of a voice or the filter cutoff, a
+      row per frame.  ROW is "set HH", which sets the pulse width to HH* 16 or
+      the cutoff to HH, "N +S" or "N -S", which adds S on each of N frames, or
+      "goto K", which carries on from row K of the table.  After the last row,
+      the table holds
+
+  pattern NAME TOKEN ..
+      TOKEN is @INSTRUMENT, which plays the notes that follow with it, a note
+      such as c4, c#4 or a#7 ( c0..a#7), "r" for a rest, or "/N", which sets
+      the length of the notes and rests that follow to N steps.  A note or a
+      rest may be given a length of its own, as in c4/2.  Every note must be
+      no more than 32 frames long and have an instrument
+
+  voice1 PATTERN .. [loop|stop]
+  voice2 ..
+  voice3 ..
+      The patterns that each voice plays, then again from the first ( loop,
+      unless given) or not ( stop).  A voice that is not given is silent
+
+A note-to-frequency table for the PAL clock and another for NTSC are packed
+with the song, of which the player takes the one for the C64 that it finds
+itself on ( see lib/video.h).  The sizes are written to stderr.
+"""
+
+import argparse
+import re
+import sys
+
+
+PAL_CLOCK = 985248
+NTSC_CLOCK = 1022727
+
+NOTES = 95  # c0..a#7.  b7 is too high for the SID's 16-bit frequency
+NOTE_NAMES = [ 'c', 'c#', 'd', 'd#', 'e', 'f', 'f#', 'g', 'g#', 'a', 'a#', 'b' ]
+A4 = 4* 12+ 9
+
+# See lib/music-player.S
+DURATION = 0x60
+INSTRUMENT = 0x80
+REST = 0xa0
+END = 0xff
+ORDER_STOP = 0xfe
+ORDER_LOOP = 0xff
+ROW_JUMP = 0x00
+ROW_SET = 0x80
+NONE = 0xff
+LONGEST = 32
+INSTRUMENTS = 32
+
+WAVES = { 'triangle': 0x10, 'sawtooth': 0x20, 'pulse': 0x40, 'noise': 0x80, 'ring': 0x04, 'sync': 0x02 }
+MODES = { 'low': 0x10, 'band': 0x20, 'high': 0x40 }
+
+
+class ScoreError( Exception):
+  pass
+
+
+def number( text, what, most ):
+  try:
+    n = int( text, 16)
+  except ValueError:
+    raise ScoreError('%s should be hex: %s' % ( what, text ))
+  if not 0 <= n <= most:
+    raise ScoreError('%s should be 0..%x: %s' % ( what, most, text ))
+  return n
+
+
+def note_of( text ):
+  m = re.match( r'^([a-g]#?)([0-7])$', text)
+  if not m  or  m.group( 1) not in NOTE_NAMES:
+    raise ScoreError('not a note: %s' % text)
+  n = 12* int( m.group( 2)) + NOTE_NAMES.index( m.group( 1))
+  if NOTES <= n:
+    raise ScoreError('too high: %s' % text)
+  return n
+
+
+# @return  The rows of a pulse or filter table as [ frames, value ] from row
+#          base of the whole table
+#
+def table( text, base ):
+  rows = []
+  for row in [ r.strip() for r in text.split(',') if r.strip() ]:
+    words = row.split()
+    if 2 == len( words) and 'set' == words[ 0]:
+      rows.append([ ROW_SET, number( words[ 1], 'set', 0xff) ])
+    elif 2 == len( words) and 'goto' == words[ 0]:
+      rows.append([ ROW_JUMP, base + int( words[ 1]) ])
+    elif 2 == len( words) and re.match( r'^[+-]\d+$', words[ 1]):
+      frames = int( words[ 0])
+      speed = int( words[ 1])
+      if not 1 <= frames <= 0x7f  or  not -128 <= speed <= 127:
+        raise ScoreError('frames should be 1..127 and the change -128..127: %s' % row)
+      rows.append([ frames, speed & 0xff ])
+    else:
+      raise ScoreError('not a row: %s' % row)
+  # Then hold, unless it goes on elsewhere
+  if not rows  or  ROW_JUMP != rows[ -1][ 0]:
+    rows.append([ ROW_JUMP, base + len( rows) ])
+  for frames, value in rows:
+    if ROW_JUMP == frames  and  not base <= value < base + len( rows):
+      raise ScoreError('goto past the end of the table')
+  return rows
+
+
+class Song:
+
+  def __init__( self):
+    self.speed = 1
+    self.instruments = {}  # name: ( number, fields as text)
+    self.tables = { 'pulse': {}, 'filter': {} }  # name: first row
+    self.rows = { 'pulse': [], 'filter': [] }
+    self.patterns = {}  # name: ( number, bytes)
+    self.voices = [ None, None, None ]
+
+  def define( self, line ):
+    words = line.split()
+    keyword = words[ 0]
+    if 'speed' == keyword:
+      self.speed = int( words[ 1])
+    elif keyword in ( 'pulse', 'filter' ):
+      name = words[ 1]
+      rows = self.rows[ keyword]
+      self.tables[ keyword][ name] = len( rows)
+      rows.extend( table( line.split( None, 2)[ 2] if 2 < len( words) else '', len( rows) ))
+      if NONE <= len( rows):
+        raise ScoreError('too many %s rows' % keyword)
+    elif 'instrument' == keyword:
+      if INSTRUMENTS <= len( self.instruments):
+        raise ScoreError('too many instruments')
+      fields = dict( w.split('=', 1) for w in words[ 2:] )
+      self.instruments[ words[ 1]] = ( len( self.instruments), fields )
+    elif 'pattern' == keyword:
+      self.patterns[ words[ 1]] = ( len( self.patterns), self.pattern( words[ 2:]) )
+      if ORDER_STOP <= len( self.patterns):
+        raise ScoreError('too many patterns')
+    elif re.match( r'^voice[123]$', keyword):
+      order = words[ 1:]
+      ending = ORDER_LOOP
+      if order and order[ -1] in ( 'loop', 'stop' ):
+        ending = ORDER_LOOP if 'loop' == order.pop() else ORDER_STOP
+      if not order:
+        raise ScoreError('%s has no patterns' % keyword)
+      self.voices[ int( keyword[ 5]) - 1] = ( order, ending )
+    else:
+      raise ScoreError('unknown: %s' % keyword)
+
+  # A duration and an instrument at most before each note, as the player
+  # expects.  Neither is known at the start of a pattern, which may follow any
+  # other.  A pattern without a note or a rest would take a read of its own,
+  # so that a voice could not reach its next note within MAX_READS
+  def pattern( self, tokens ):
+    out = []
+    steps = 1
+    instrument = None
+    playing = None
+    duration = None
+    for token in tokens:
+      if token.startswith('/'):
+        steps = int( token[ 1:])
+        continue
+      if token.startswith('@'):
+        if token[ 1:] not in self.instruments:
+          raise ScoreError('no such instrument: %s' % token)
+        instrument = self.instruments[ token[ 1:]][ 0]
+        continue
+      name, _, length = token.partition('/')
+      frames = ( int( length) if length else steps ) * self.speed
+      if not 1 <= frames <= LONGEST:
+        raise ScoreError('%s is %d frames, not 1..%d' % ( token, frames, LONGEST ))
+      if frames != duration:
+        out.append( DURATION | ( frames - 1))
+        duration = frames
+      if 'r' == name:
+        out.append( REST)
+        continue
+      if instrument is None:
+        raise ScoreError('no instrument for %s' % token)
+      if instrument != playing:
+        out.append( INSTRUMENT | instrument)
+        playing = instrument
+      out.append( note_of( name))
+    if not out:
+      raise ScoreError('a pattern needs a note or a rest')
+    out.append( END)
+    return out
+
+  def instrument( self, fields ):
+    wave = 0
+    for w in fields.get('wave', '').split('+'):
+      if w not in WAVES:
+        raise ScoreError('not a wave: %s' % w)
+      wave |= WAVES[ w]
+    mode = 0
+    for m in fields.get('mode', 'low').split('+'):
+      if m not in MODES:
+        raise ScoreError('not a filter mode: %s' % m)
+      mode |= MODES[ m]
+    def row_of( kind ):
+      if kind not in fields:
+        return NONE
+      if fields[ kind] not in self.tables[ kind]:
+        raise ScoreError('no such %s table: %s' % ( kind, fields[ kind] ))
+      return self.tables[ kind][ fields[ kind]]
+    return [
+      number( fields.get('ad', '09'), 'ad', 0xff),
+      number( fields.get('sr', '00'), 'sr', 0xff),
+      wave,
+      number( fields.get('pw', '8'), 'pw', 0xf),
+      row_of('pulse'),
+      row_of('filter'),
+      number( fields.get('resonance', '0'), 'resonance', 0xf) << 4,
+      mode,
+    ]
+
+
+def lines_of( text ):
+  out = []
+  for line in text.split('\n'):
+    line = line.split(';', 1)[ 0].rstrip()
+    if not line.strip():
+      continue
+    if line[ 0].isspace() and out:
+      out[ -1] += ' ' + line.strip()
+    else:
+      out.append( line.strip())
+  return out
+
+
+def bytes_of( label, values ):
+  print( label + ':')
+  for i in range( 0, len( values), 16):
+    print('  .byt ' + ', '.join( '$%02x' % b for b in values[ i:i+16] ))
+
+
+def main():
+  parser = argparse.ArgumentParser( description = __doc__.strip().split('\n')[0] )
+  parser.add_argument('score', help = 'text score')
+  args = parser.parse_args()
+
+  song = Song()
+  with open( args.score) as f:
+    for number_of_line, line in enumerate( lines_of( f.read()), 1):
+      try:
+        song.define( line)
+      except ( ScoreError, ValueError, IndexError ) as e:
+        parser.error('%s: definition %d: %s' % ( args.score, number_of_line, e ))
+
+  try:
+    instruments = [ song.instrument( fields) for _, fields in sorted( song.instruments.values()) ]
+    orders = []
+    for v in song.voices:
+      if v is None:
+        orders.append([ ORDER_STOP ])
+        continue
+      order, ending = v
+      for name in order:
+        if name not in song.patterns:
+          raise ScoreError('no such pattern: %s' % name)
+      orders.append([ song.patterns[ name][ 0] for name in order ] + [ ending ])
+  except ScoreError as e:
+    parser.error('%s: %s' % ( args.score, e ))
+
+  def frequencies( clock ):
+    return [ round( 440 * 2 ** (( n - A4) / 12) * ( 1 << 24) / clock ) for n in range( NOTES) ]
+
+  print('; Generated by %s.  Do not edit' % ' '.join( [ 'pack-music.py'] + sys.argv[1:] ))
+  print()
+  for name in ( 'order_1', 'order_2', 'order_3', 'patterns_lo', 'patterns_hi', 'instruments',
+                'pulse_frames', 'pulse_values', 'filter_frames', 'filter_values', 'freq_lo', 'freq_hi',
+                'ntsc_freq_lo', 'ntsc_freq_hi' ):
+    print('.export music_%s' % name)
+  print()
+  print('.rodata')
+  print()
+  for v, order in enumerate( orders):
+    bytes_of('music_order_%d' % ( v + 1), order)
+  patterns = [ p for _, p in sorted( song.patterns.values()) ]
+  print('music_patterns_lo:')
+  for i in range( len( patterns)):
+    print('  .lobytes pattern_%d' % i)
+  print('music_patterns_hi:')
+  for i in range( len( patterns)):
+    print('  .hibytes pattern_%d' % i)
+  for i, p in enumerate( patterns):
+    bytes_of('pattern_%d' % i, p)
+  bytes_of('music_instruments', sum( instruments, []))
+  for kind in ( 'pulse', 'filter' ):
+    bytes_of('music_%s_frames' % kind, [ r[ 0] for r in song.rows[ kind] ])
+    bytes_of('music_%s_values' % kind, [ r[ 1] for r in song.rows[ kind] ])
+  for name, clock in ( 'freq', PAL_CLOCK ), ( 'ntsc_freq', NTSC_CLOCK ):
+    freq = frequencies( clock)
+    bytes_of('music_%s_lo' % name, [ f & 0xff for f in freq ])
+    bytes_of('music_%s_hi' % name, [ f >> 8 for f in freq ])
+  print()
+
+  size = sum( len( o) for o in orders) + sum( len( p) + 2 for p in patterns) + 8 * len( instruments) \
+    + 2 * ( len( song.rows['pulse']) + len( song.rows['filter']) )
+  sys.stderr.write('pack-music.py: %d patterns, %d instruments, %d bytes packed and %d of frequencies\n'
+    % ( len( patterns), len( instruments), size, 4 * NOTES ))
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Packs a world of tile_pattern_ids ( ca65 source) a row of tiles at a time for
+unpack_row() in examples/8-way-tiles, which decodes each row in to a cache as
+it scrolls in to view.
+
+  pack-world.py --width TILES --height TILES [--prefix NAME] [MAP] > world.S
+
+MAP is a file of width x height bytes, one tile_pattern_id per tile, a row at a
+time.  Without it, the world that examples/8-way-tiles/main.c fills in is
+packed, which has no runs and so is the worst case for size and for the time
+taken to unpack it.
+
+Each row is run-length encoded as a sequence of chunks, each of which begins
+with a control byte:
+
+  $00..$7f  n+1 literal tile_pattern_ids follow
+  $81..$ff  the tile_pattern_id that follows is repeated ( control & $7f)+1
+            times
+  $80       the end of the row
+
+A table of the addresses of the rows, _<prefix>rows, is also generated.  The
+sizes are written to stderr.
+"""
+
+import argparse
+import sys
+
+
+LONGEST = 128
+END = 0x80
+
+
+# @return  The chunks of the row, without the end marker
+#
+def pack( row ):
+  out = []
+  literal = []
+
+  def flush():
+    if literal:
+      out.extend( [ len( literal) - 1 ] + literal)
+      del literal[:]
+
+  i = 0
+  while i < len( row):
+    run = 1
+    while i + run < len( row) and run < LONGEST and row[ i + run] == row[ i]:
+      run += 1
+    # A run of 2 costs as much as two literals and would split a literal chunk
+    if 3 <= run  or  ( 2 == run and not literal ):
+      flush()
+      out.extend([ 0x80 | ( run - 1), row[ i] ])
+      i += run
+    else:
+      literal.append( row[ i])
+      if LONGEST == len( literal):
+        flush()
+      i += 1
+  flush()
+  return out
+
+
+def main():
+  parser = argparse.ArgumentParser( description = __doc__.strip().split('\n')[0] )
+  parser.add_argument('--width', type = int, required = True, help = 'of the world in tiles ( 1..256)')
+  parser.add_argument('--height', type = int, required = True, help = 'of the world in tiles ( 1..256)')
+  parser.add_argument('--prefix', default = 'world_', help = 'of the name of the table of rows')
+  parser.add_argument('map', nargs = '?', help = 'file of width x height tile_pattern_ids')
+  args = parser.parse_args()
+  for n in ( args.width, args.height ):
+    if not 1 <= n <= 256:
+      parser.error('--width and --height must be 1..256')
+
+  if args.map:
+    with open( args.map, 'rb') as f:
+      tiles = list( f.read())
+    if len( tiles) != args.width * args.height:
+      parser.error('%s should be %d bytes' % ( args.map, args.width * args.height ))
+  else:
+    tiles = [ ( args.width * y + x) & 0xff for y in range( args.height) for x in range( args.width) ]
+
+  rows = [ pack( tiles[ y * args.width:( y + 1) * args.width]) + [ END] for y in range( args.height) ]
+
+  print('; Generated by %s.  Do not edit' % ' '.join( [ 'pack-world.py'] + sys.argv[1:] ))
+  print()
+  print('.export _%srows' % args.prefix)
+  print()
+  print('.rodata')
+  print()
+  print('_%srows:' % args.prefix)
+  for y in range( args.height):
+    print('  .addr @row%d' % y)
+  for y, row in enumerate( rows):
+    print('@row%d:' % y)
+    for i in range( 0, len( row), 16):
+      print('  .byt ' + ', '.join( '$%02x' % b for b in row[ i:i+16] ))
+  print()
+
+  packed = sum( len( row) for row in rows) + 2 * args.height
+  sys.stderr.write('pack-world.py: %d x %d tiles, %d bytes packed ( including %d of table) from %d\n'
+    % ( args.width, args.height, packed, 2 * args.height, len( tiles) ))
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,81 @@
+
+#include "raster.h"
+#include "video.h"
+
+
+// The table that raster-irq.S runs through, sorted by line.  Bit 8 of each line
+// is kept apart from the other 8 bits and each handler as LO and HI bytes so
+// that the IRQ handler can index them by X
+uint8_t  raster_splits = 0;
+uint8_t  raster_line_lo[ RASTER_SPLITS];
+uint8_t  raster_line_hi[ RASTER_SPLITS];
+uint8_t  raster_handler_lo[ RASTER_SPLITS];
+uint8_t  raster_handler_hi[ RASTER_SPLITS];
+// How raster-irq.S calls each handler
+#define  KIND_ASM     0x00
+#define  KIND_C       0x80
+#define  KIND_STABLE  0x40
+uint8_t  raster_kind[ RASTER_SPLITS];
+
+
+static bool  add( uint16_t line, RasterHandler handler, uint8_t kind )
+{
+  uint8_t  i;
+
+  if ( RASTER_SPLITS == raster_splits )
+    return false;
+
+  // So that the IRQ handler never sees the table half-changed.  The flags are
+  // put back afterwards rather than interrupts enabled, since this may be
+  // called before raster_init() or with interrupts off on purpose
+  __asm__( "php");
+  __asm__( "sei");
+
+  // Move the handlers at later lines up to make room
+  for ( i = raster_splits;  0 < i;  i -= 1 )
+  {
+    if ( raster_line_hi[ i- 1] < ( line >> 8)  ||
+         ( raster_line_hi[ i- 1] == ( line >> 8)  &&  raster_line_lo[ i- 1] <= (uint8_t)line ) )
+      break;
+    raster_line_lo[ i] = raster_line_lo[ i- 1];
+    raster_line_hi[ i] = raster_line_hi[ i- 1];
+    raster_handler_lo[ i] = raster_handler_lo[ i- 1];
+    raster_handler_hi[ i] = raster_handler_hi[ i- 1];
+    raster_kind[ i] = raster_kind[ i- 1];
+  }
+  raster_line_lo[ i] = line;
+  raster_line_hi[ i] = line >> 8;
+  raster_handler_lo[ i] = (uint16_t)handler;
+  raster_handler_hi[ i] = (uint16_t)handler >> 8;
+  raster_kind[ i] = kind;
+  raster_splits += 1;
+
+  __asm__( "plp");
+
+  return true;
+}
+
+
+bool  raster_add( uint16_t line, RasterHandler handler )
+{
+  return add( line, handler, KIND_C);
+}
+
+
+bool  raster_add_asm( uint16_t line, RasterHandler handler )
+{
+  return add( line, handler, KIND_ASM);
+}
+
+
+bool  raster_add_stable( uint16_t line, RasterHandler handler )
+{
+  // raster-irq.S is timed for PAL's 63 cycles per line
+  if ( VIDEO_PAL != video_standard )
+    return false;
+
+  // raster-irq.S is first interrupted 4 lines before, and then again on the
+  // line before, to take out the jitter
+  return add( line- RASTER_STABLE_LEAD, handler, KIND_STABLE);
+}
+
@@ -0,0 +1,61 @@
+
+#ifndef __RASTER_H
+#define __RASTER_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/* Runs handlers at raster lines from a table sorted by line, one raster IRQ
+   after another, so that a status bar split, a music tick and a scroll update
+   can share a frame */
+
+// The most handlers that may be added
+#define  RASTER_SPLITS  8
+
+typedef void (*RasterHandler)( void);
+
+
+// Adds a handler written in C, to run at the given raster line ( 0..311 on
+// PAL, 0..262 on NTSC).  The zero-page registers of cc65's runtime are saved
+// around it and it runs on a C stack of its own, so that it does not disturb
+// the C that it interrupts.  That costs about 300 cycles.  Handlers at the same
+// line run in the order added.  Returns false if there are already
+// RASTER_SPLITS handlers
+extern bool __fastcall__  raster_add( uint16_t line, RasterHandler handler );
+
+// As raster_add() for a handler written in assembly, which is called straight
+// away without any saving.  It may use A, X and Y but not the zero page of C
+extern bool __fastcall__  raster_add_asm( uint16_t line, RasterHandler handler );
+
+// As raster_add_asm() for a handler that must start on the same cycle every
+// frame, such as one that changes a colour part of the way across a line.  The
+// handler's first instruction is always on cycle RASTER_STABLE_CYCLE of the
+// given line, counting the first cycle of the line as 0.  Only on PAL: the run
+// of NOPs and the compare of $d012 are timed for its 63 cycles per line and
+// not for the 65 of NTSC ( or 64 of the first NTSC VIC), so this returns false
+// unless video_probe() from video.h has found PAL, which it assumes until it
+// is called.  It takes two raster IRQs: one RASTER_STABLE_LEAD lines before,
+// which sets up the second on the line before and waits for it in a run of
+// NOPs, so that the second starts with a jitter of one cycle rather than up to
+// 7, which a compare of $d012 across the end of that line takes out.  So the
+// line must be at least RASTER_STABLE_LEAD, neither it nor the line before it
+// may be a badline or have sprites on it, raster_init() must be told not to
+// chain the KERNAL, whose CIA IRQs would break in, and any other handler must
+// be done a few lines before the first IRQ.  If the first IRQ is too late for
+// the second then the handler is run late rather than not at all
+#define  RASTER_STABLE_LEAD   4
+#define  RASTER_STABLE_CYCLE  9
+extern bool __fastcall__  raster_add_stable( uint16_t line, RasterHandler handler );
+
+// Installs the raster IRQ handler, once at least one handler has been added.
+// With chain_kernal, IRQs from the CIAs are passed on to the KERNAL's handler,
+// which scans the keyboard and counts the jiffy clock.  Otherwise CIA#1
+// interrupts are disabled.  A handler must leave the raster compare registers
+// alone, although it may write VIC.ctrl1
+extern void __fastcall__  raster_init( bool chain_kernal );
+
+
+#endif
+
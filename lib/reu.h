@@ -0,0 +1,31 @@
+
+#ifndef __REU_H
+#define __REU_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/* Shifts the 40x25 character matrix by DMA with a 17xx RAM Expansion Unit */
+
+
+// Whether a REU is present.  reu_shift() does not check, so find out first
+extern bool  reu_detect( void);
+
+// The character matrices that reu_shift() shifts from and to.  Both are
+// $0400 to begin with, which shifts in place
+extern uint8_t *reu_from;
+extern uint8_t *reu_to;
+
+// Writes the matrix at reu_from shifted by offset cells to reu_to, by way of
+// REU bank 0 from $0000.  The offset is as for coarse_scroll() in
+// examples/8-way-scroll: +1 moves the characters right, -40 up and so on, and
+// may be several rows and columns at once.  The exposed cells are left as they
+// were, except that the first or last columns take the characters that wrap
+// around from the next or previous row
+extern void __fastcall__  reu_shift( int16_t offset );
+
+
+#endif
+
@@ -0,0 +1,31 @@
+#ifndef __SHIFT_CELLS_H
+#define __SHIFT_CELLS_H
+
+
+#include <stdint.h>
+
+
+/* Shifts the 40x25 character matrix by up to 4 cells each way in one pass,
+   for panning the view by several cells at once */
+
+
+// The most cells that shift_cells() moves the characters each way
+#define  SHIFT_CELLS_MAX_STEP  4
+
+// The character matrices that shift_cells() shifts from and to.  Both are
+// $0400 to begin with, which shifts in place
+extern uint8_t *shift_from;
+extern uint8_t *shift_to;
+
+// Writes the matrix at shift_from shifted by offset cells to shift_to.  The
+// offset is 40* dy+ dx, where dx and dy are each -4..+4, and is as for
+// reu_shift(): +1 moves the characters right, -80 up by two rows and so on.
+// The exposed rows and columns are left as they were.  make bench in lib/bench
+// measures it as shift_cells by steps of 2 to 4 cells.  It patches the copy
+// for the step on every call, so a step of one cell is better left to the
+// routines of lib/gen-scroll.py
+extern void __fastcall__  shift_cells( int16_t offset );
+
+
+#endif
+
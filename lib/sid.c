@@ -0,0 +1,22 @@
+
+#include "sid.h"
+
+
+static const uint8_t  bit_of[] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+
+void __fastcall__ sid_mark( uint8_t offset )
+{
+  // The raster IRQ may flush and clear the mask between the read and the
+  // write of this, which marks again what it has just flushed but loses
+  // nothing
+  sid_dirty[ offset >> 3] |= bit_of[ offset & 7];
+}
+
+
+void __fastcall__ sid_write( uint8_t offset, uint8_t value )
+{
+  sid_shadow[ offset] = value;
+  sid_mark( offset);
+}
+
@@ -0,0 +1,51 @@
+#ifndef __SID_H
+#define __SID_H
+
+
+#include <stdint.h>
+#include <c64.h>
+
+
+/* Keeps a shadow of the SID's registers, which are write-only, and writes to
+   the SID only those that have changed, once per frame from the raster IRQ and
+   in an order that does not glitch the envelopes.  So the cost and the timing
+   of SID writes are the same however and whenever the registers are changed */
+
+// $d400..$d418.  The read-only registers after them are read from the SID
+#define  SID_REGISTERS  25
+
+// The offsets of the registers of each voice from those of voice 1
+#define  SID_VOICE( v)  ( 7* (v))
+
+// As cc65's SID but of the shadow
+#define  SID_SHADOW  ( *(struct __sid*)sid_shadow)
+
+
+// The values that the SID's registers are to have, from the next flush.  One
+// that is written here directly must then be marked with sid_mark()
+extern uint8_t  sid_shadow[ SID_REGISTERS];
+
+// A bit per register, $d400 being bit 0 of the first byte, set for those that
+// have been written since the last flush
+extern uint8_t  sid_dirty[ 4];
+
+// Writes value to the shadow of the register at offset ( 0..24) from $d400
+// and marks it
+extern void __fastcall__  sid_write( uint8_t offset, uint8_t value );
+
+// Marks the register at offset from $d400 to be flushed
+extern void __fastcall__  sid_mark( uint8_t offset );
+
+// See sid-flush.S.  A handler for raster_add_asm() that writes each marked
+// register to the SID, once per frame.  The frequency, pulse width and
+// envelope of each voice are written before its control register, so that a
+// note is gated with its envelope and released with its release rate, and
+// the filter and volume come last.  Whatever is written to a register between
+// flushes, only the last value reaches the SID, so a voice must be gated off
+// for a frame to be gated on again.  Costs 260 cycles with nothing marked and
+// no more than 440
+extern void  sid_flush( void);
+
+
+#endif
+
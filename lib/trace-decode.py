@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Decodes the events that lib/trace-send.S sends out of the userport, as dumped
+to a file by VICE, in to a timeline and histograms of the time between them.
+
+  trace-decode.py [--name ID=NAME ..] [--summary] DUMP
+
+Each event is 6 bytes: its id, with bit 8 of the raster line in bit 7, the
+bottom 8 bits of the line, a stamp from a timer that counts down by one per
+cycle, and a payload, each LO byte first.  Ids are 0..63, and an id with
+TRACE_END ( $40) ends the span begun by the last event of the same id.
+
+The timeline gives each event the time since TRACE_START, in cycles and in
+milliseconds, its raster line and its payload, and for the end of a span how
+long it took.  The stamp is 16 bits, so each event must be within 65536
+cycles, 3.3 frames, of the one before for the time to carry on from it.  Then
+for each id there is a histogram of how long its spans took and of the time
+from each event to the next of that id.
+"""
+
+import argparse
+import sys
+
+
+# See lib/trace.h
+RECORD = 6
+TRACE_END = 0x40
+TRACE_START = 0x00
+TRACE_DROPPED = 0x3f
+
+# By the VIDEO_* of lib/video.h that TRACE_START carries
+CLOCKS = { 0: ( 'PAL', 985248), 1: ( 'NTSC', 1022727), 2: ( 'old NTSC', 1022727) }
+
+HISTOGRAM_WIDTH = 40
+
+
+def is_start( record):
+  return ( record[0] & 0x7f) == TRACE_START and record[5] == 0 and record[4] in CLOCKS
+
+
+def records_of( data):
+  """The events of the dump, from the first TRACE_START"""
+  for at in range( len( data) - RECORD + 1):
+    if is_start( data[ at:at + RECORD]):
+      break
+  else:
+    sys.exit('trace-decode.py: no TRACE_START in the dump')
+  if at:
+    sys.stderr.write('trace-decode.py: skipped %d bytes before TRACE_START\n' % at)
+  return [ data[ i:i + RECORD] for i in range( at, len( data) - RECORD + 1, RECORD) ]
+
+
+class Histogram:
+
+  def __init__( self):
+    self.values = []
+
+  def add( self, value):
+    self.values.append( value)
+
+  def write( self, title, clock):
+    """Buckets of powers of 2 cycles"""
+    values = self.values
+    print('%s: %d, %d..%d cycles, mean %d ( %.3f ms)' % ( title, len( values), min( values),
+      max( values), sum( values) / len( values), sum( values) * 1000.0 / len( values) / clock ))
+    buckets = {}
+    for value in values:
+      bucket = value.bit_length()
+      buckets[ bucket] = buckets.get( bucket, 0) + 1
+    most = max( buckets.values())
+    for bucket in range( min( buckets), max( buckets) + 1):
+      count = buckets.get( bucket, 0)
+      low = 1 << bucket - 1 if bucket else 0
+      print('  %6d..%-6d %6d %s' % ( low, ( 1 << bucket) - 1, count,
+        '#' * (( count * HISTOGRAM_WIDTH + most - 1) // most) ))
+    print()
+
+
+def main():
+  parser = argparse.ArgumentParser( description = __doc__.strip().split('\n')[0] )
+  parser.add_argument('dump', help = 'the bytes dumped by VICE')
+  parser.add_argument('--name', action = 'append', default = [], metavar = 'ID=NAME',
+    help = 'a name for an id, which may be given in hex as $NN or 0xNN')
+  parser.add_argument('--summary', action = 'store_true', help = 'only the histograms')
+  args = parser.parse_args()
+
+  names = { TRACE_START: 'start', TRACE_DROPPED: 'dropped' }
+  for name in args.name:
+    id, name = name.split('=', 1)
+    names[ int( id.replace('$', '0x'), 0) & ~TRACE_END] = name
+
+  with open( args.dump, 'rb') as f:
+    records = records_of( f.read())
+
+  clock = None
+  time = 0
+  stamp = None
+  begun = {}    # By id, the time of the span that it began
+  last = {}     # By id, the time of the last event
+  spans = {}    # By id, a Histogram
+  intervals = {}
+  for record in records:
+    id = record[0] & 0x7f
+    line = ( record[0] & 0x80) << 1 | record[1]
+    this_stamp = record[3] << 8 | record[2]
+    payload = record[5] << 8 | record[4]
+    name = names.get( id & ~TRACE_END, '$%02x' % ( id & ~TRACE_END))
+
+    if is_start( record):
+      standard, clock = CLOCKS[ payload]
+      time = 0
+      begun = {}
+      last = {}
+      if not args.summary:
+        print('%10s %9s %4s  start on %s' % ( 'cycles', 'ms', 'line', standard))
+    else:
+      # The timer counts down
+      time += ( stamp - this_stamp) & 0xffff
+    stamp = this_stamp
+
+    took = ''
+    if id & TRACE_END:
+      base = id & ~TRACE_END
+      if base in begun:
+        span = time - begun.pop( base)
+        spans.setdefault( base, Histogram()).add( span)
+        took = '  took %d' % span
+      name = 'end ' + name
+    else:
+      if id in last:
+        intervals.setdefault( id, Histogram()).add( time - last[ id])
+      last[ id] = time
+      begun[ id] = time
+
+    if not args.summary and not is_start( record):
+      print('%10d %9.3f %4d  %-16s $%04x %5d%s' % ( time, time * 1000.0 / clock, line, name,
+        payload, payload, took ))
+
+  if not args.summary:
+    print()
+  for id in sorted( set( spans) | set( intervals)):
+    name = names.get( id, '$%02x' % id)
+    if id in spans:
+      spans[ id].write('%s, from its start to its end' % name, clock)
+    if id in intervals:
+      intervals[ id].write('%s, from one to the next' % name, clock)
+
+
+if __name__ == '__main__':
+  main()
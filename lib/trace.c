@@ -0,0 +1,15 @@
+
+#include "trace.h"
+#include "video.h"
+
+
+// See trace-send.S.  Starts the timers and the NMI handler, with CIA#2's
+// timer A underflowing every latch+ 1 cycles, once per bit
+extern void __fastcall__  trace_start( uint16_t latch );
+
+
+void __fastcall__ trace_init( uint16_t baud )
+{
+  trace_start( ( video_clock + baud / 2) / baud - 1 );
+  trace( TRACE_START, video_standard );
+}
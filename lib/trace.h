@@ -0,0 +1,67 @@
+#ifndef __TRACE_H
+#define __TRACE_H
+
+
+#include <stdint.h>
+
+
+/* Records events in to a ring buffer, each stamped with the raster line and a
+   free-running CIA timer, and sends them out of the userport's RS-232 line
+   from an NMI per bit, so that the raster IRQ and the main loop can be traced
+   without waiting on the KERNAL's CHROUT.  lib/trace-decode.py turns what
+   VICE dumps to a file in to a timeline and histograms of the time between
+   events
+
+   Each event is 6 bytes on the line: its id with bit 8 of the raster line in
+   bit 7, the bottom 8 bits of the line, the stamp, LO byte first, and the
+   payload, LO byte first.  The stamp is CIA#2's timer B, which counts down by
+   one per cycle from $ffff */
+
+// Ids are 0..63, with TRACE_END for the end of a span begun by the same id.
+// trace-decode.py measures how long each span took
+#define  TRACE_END  0x40
+
+// Sent by trace_init(), with the VIDEO_* of video.h as the payload, so that
+// the decoder knows the clock
+#define  TRACE_START    0x00
+// Sent before the next event that there is room for after events were lost to
+// a full buffer, with how many were lost as the payload
+#define  TRACE_DROPPED  0x3f
+
+// Rates that the userport line can be sent at.  The NMI of each bit can be
+// held up by up to about 60 cycles by a badline, sprites and the instruction
+// that it interrupts.  At TRACE_4800 that is well within half of a bit, which
+// is where it is sampled, whereas at TRACE_9600 it is not, with the screen on
+#define  TRACE_2400  2400
+#define  TRACE_4800  4800
+#define  TRACE_9600  9600
+
+// The bytes of events that can wait to be sent, in 6s
+#define  TRACE_BUFFER  256
+
+
+// Events lost to a full buffer since the last TRACE_DROPPED
+extern volatile uint16_t  trace_dropped;
+
+
+// Takes over CIA#2's timers and NMIs, and bit 2 of its port A as the userport
+// line, and sends TRACE_START.  Call video_probe() first so that the rate is
+// timed to the right clock.  The KERNAL's RS-232 must not be open.  The RESTORE
+// key's NMI is passed on to the KERNAL, whose handler disables the NMIs that
+// send, and then enables them again.  A bit due whilst the KERNAL's handler
+// runs goes out late, so pressing RESTORE whilst a byte is being sent may
+// garble that byte.  Code that must be timed to the cycle, such as a handler
+// added with raster_add_stable(), is thrown out by the NMIs whilst there are
+// events to send, which cost about 80 cycles per bit, so 40% of the CPU at
+// TRACE_4800, for 480 bytes or 80 events a second
+extern void __fastcall__  trace_init( uint16_t baud );
+
+// See trace-send.S.  Records an event.  From the main loop or from a handler
+// of raster_add(), but not from an NMI.  If there is no room, the event is
+// lost and counted in trace_dropped.  Costs about 220 cycles.  From assembly,
+// such as a handler of raster_add_asm(), jsr trace_event with the id in A and
+// the payload in X, LO, and Y, HI, which does not use the zero page of C
+extern void __fastcall__  trace( uint8_t id, uint16_t payload );
+
+
+#endif
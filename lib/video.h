@@ -0,0 +1,59 @@
+#ifndef __VIDEO_H
+#define __VIDEO_H
+
+
+#include <stdint.h>
+
+
+/* Tells a PAL C64 from an NTSC one by the number of raster lines in a frame,
+   and gives the clock and the timing of whichever it is, so that the rest need
+   not assume PAL */
+
+#define  VIDEO_PAL       0  // 312 lines of 63 cycles, 50 frames a second
+#define  VIDEO_NTSC      1  // 263 lines of 65 cycles, 60 frames a second
+#define  VIDEO_NTSC_OLD  2  // The first 6567, 262 lines of 64 cycles
+
+// The first and the last raster lines of the 200 lines of the screen with 25
+// rows, which are the same on PAL and NTSC.  The border and the vertical blank
+// of the lines after VIDEO_SCREEN_BOTTOM and before VIDEO_SCREEN_TOP are
+// video_border_lines
+#define  VIDEO_SCREEN_TOP      51
+#define  VIDEO_SCREEN_BOTTOM  250
+
+
+// VIDEO_* as found by video_probe().  Each of these is as for PAL until then
+extern uint8_t   video_standard;
+// The CPU clock, in Hz: 985248 on PAL, 1022727 on NTSC
+extern uint32_t  video_clock;
+extern uint16_t  video_lines;
+extern uint8_t   video_cycles_per_line;
+extern uint8_t   video_frame_rate;
+// The lines of each frame outside of the screen, from the end of one to the
+// start of the next, which is when a raster IRQ can do the most without being
+// seen: 112 on PAL and 63 on NTSC
+extern uint16_t  video_border_lines;
+// The line from which a raster IRQ has as many cycles before VIDEO_SCREEN_TOP
+// as one at VIDEO_SCREEN_BOTTOM has on PAL, about 7100.  That is
+// VIDEO_SCREEN_BOTTOM on PAL, and 200 on NTSC ( 197 on the first VIC), whose
+// border is shorter.  For a handler that changes the screen in place and must
+// be done by the top of it, which then starts whilst the last rows are still
+// being shown
+extern uint16_t  video_budget_line;
+
+// Set by video_pace() for one frame in six on NTSC and never on PAL.  A handler
+// that moves something on by a frame at a time, such as a music tick or a step
+// of physics, does nothing in such a frame to keep to 50 steps a second, so
+// that it goes at the same speed as on PAL
+extern volatile uint8_t  video_skip;
+
+
+// Counts the raster lines of a frame, which takes up to two frames with IRQs
+// disabled, and sets the above to match
+extern void  video_probe( void);
+
+// See video.S.  A handler for raster_add_asm() that sets video_skip.  Add it
+// before the handlers that look at it, at the same line.  Costs 20 cycles
+extern void  video_pace( void);
+
+
+#endif
@@ -0,0 +1,54 @@
+
+#include "watch.h"
+#include <c64.h>
+#include <conio.h>
+#include <string.h>
+
+
+#define  SCREEN  ((uint8_t*) 0x0400)
+
+
+// The characters of each format that are fixed in width
+static const uint8_t  width_of[] = { 0, 2, 4, 3, 5, 4, 6 };
+
+
+static uint8_t  width( WatchField *field )
+{
+  switch ( field->format)
+  {
+    case WATCH_BITS:
+      return strlen( field->symbols);
+
+    case WATCH_TEXT:
+      return strlen( *(const char**)field->value);
+
+    default:
+      return width_of[ field->format];
+  }
+}
+
+
+void __fastcall__ watch_draw( WatchField *fields )
+{
+  WatchField *field;
+  uint8_t     color = textcolor( COLOR_WHITE);
+  uint16_t    at;
+
+  textcolor( color);
+  for ( field = fields;  WATCH_END != field->format;  field += 1 )
+  {
+    at = 40* field->row+ field->column;
+    if ( field->label )
+    {
+      cputsxy( field->column, field->row, field->label);
+      at += strlen( field->label);
+    }
+    field->screen = SCREEN+ at;
+    field->width = width( field);
+    // The KERNAL's clear screen may leave the color RAM as the background
+    memset( COLOR_RAM+ at, color, field->width );
+    field->format |= WATCH_STALE;
+  }
+
+  watch_update( fields);
+}
@@ -0,0 +1,72 @@
+#ifndef __WATCH_H
+#define __WATCH_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* A panel of values watched on the text screen.  The labels are drawn once by
+   watch_draw() and then watch_update() writes only the characters of the
+   values that changed, straight to the screen at $0400, rather than through
+   conio, which is for screens that show the state of something under test as
+   it runs without slowing it down */
+
+// How a WatchField shows its value
+#define  WATCH_LABEL     0  // None, only the label
+#define  WATCH_HEX8      1  // 2 hex digits of a byte
+#define  WATCH_HEX16     2  // 4 hex digits of a word
+#define  WATCH_DEC8      3  // 3 decimal digits of a uint8_t, right-aligned
+#define  WATCH_DEC16     4  // 5 decimal digits of a uint16_t, right-aligned
+#define  WATCH_SIGNED8   5  // A sign and 3 decimal digits of an int8_t
+#define  WATCH_SIGNED16  6  // A sign and 5 decimal digits of an int16_t
+#define  WATCH_BITS      7  // A symbol for each set bit and '-' for each clear
+#define  WATCH_TEXT      8  // The string that a char* points to
+#define  WATCH_END    0x7f  // After the last field
+
+// Set in the format by watch_draw() so that the next watch_update() writes the
+// value whatever it was before
+#define  WATCH_STALE  0x80
+
+
+typedef struct
+{
+  // Drawn from column and row, and the value straight after it.  Or NULL
+  const char *label;
+  uint8_t     column;
+  uint8_t     row;
+  uint8_t     format;   // WATCH_*
+  const void *value;    // What is watched.  For WATCH_TEXT, a char*
+  // For WATCH_BITS, the symbols of the bits shown, from the highest.  "abc"
+  // shows bits 2, 1 and 0
+  const char *symbols;
+  // Where the value is on the screen, as it was when it was last written and
+  // how many characters it takes there.  For WATCH_TEXT, the width is that of
+  // the longest string yet, to which shorter ones are padded with spaces.  Set
+  // by watch_draw() and watch_update()
+  uint8_t    *screen;
+  uint16_t    shown;
+  uint8_t     width;
+}
+WatchField;
+
+// Ends an array of WatchField
+#define  WATCH_FIELDS_END  { NULL, 0, 0, WATCH_END }
+
+
+// Draws the label of each field up to WATCH_FIELDS_END, sets the color of
+// where each value goes to that of conio, and then writes each value.  Again
+// after the screen is cleared.  The color is set for a string of WATCH_TEXT as
+// long as it is now, so draw with the longest that it will be
+extern void __fastcall__  watch_draw( WatchField *fields );
+
+// See watch-update.S.  Writes each value that has changed since it was last
+// written, and only those of its characters that differ from what is on the
+// screen.  A string of WATCH_TEXT is compared with the screen character by
+// character every time, so that one that is changed in place is shown too.
+// Costs about 100 cycles for each field that has not changed and up to 900
+// for each that has, and about 50 for each character of a string
+extern void __fastcall__  watch_update( WatchField *fields );
+
+
+#endif